@@ -0,0 +1,419 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "align.h"
+
+// dumps of the same disc taken with other drives or intervals
+//  are resampled onto one sector grid, then the offset of each one
+//  to the first dump is found by cross correlation in frequency domain
+
+static int load_crv (char *path, CRV *crv, OPT *opt)
+{
+     FILE *file = NULL ;
+     SRC src = {0} ;
+
+     int error = 0 ;
+
+     if (test_src (path))
+     {
+          if (open_src (path, &src) != 0)
+               { error = 1 ; goto quit ; }
+          if (pull_mds (&src, &crv->mds) != 0)
+               { error = 2 ; goto quit ; }
+     }
+     else
+     {
+          file = fopen (path, "rb") ;
+          if (file == NULL)
+               { error = 1 ; goto quit ; }
+          if (read_mds (file, &crv->mds) != 0)
+               { error = 2 ; goto quit ; }
+     }
+
+     if (make_arn (&crv->arn, size_arn (&crv->mds, opt, path), opt->huge) != 0)
+          { error = 3 ; goto quit ; }
+
+     if (get_name (path, &crv->name, &crv->arn) != 0)
+          { error = 1 ; goto quit ; }
+
+     crv->dpm = make_dpm (&crv->arn, crv->mds.smp) ;
+     if (crv->dpm == NULL)
+          { error = 3 ; goto quit ; }
+
+     if (src.file != NULL)
+     {
+          if (pull_dpm (&src, &crv->mds, crv->dpm) != 0)
+               { error = 4 ; goto quit ; }
+     }
+     else read_dpm (file, &crv->mds, crv->dpm) ;
+
+     quit :
+
+     if (file != NULL)
+          fclose (file) ;
+     if (src.file != NULL)
+          close_src (&src) ;
+
+     return error ;
+}
+
+static void grid_crv (CRV *crv, double *grid, unsigned int step, unsigned int cnt)
+{
+     // time per sector of every cell of the grid,
+     //  each sample spreading its timing evenly over its sectors
+
+     unsigned int itv = crv->mds.itv ;
+     unsigned int i = 0 ;
+
+     for (unsigned int g = 0 ; g < cnt ; g++)
+     {
+          unsigned long stt = (unsigned long) g * step ;
+          unsigned long stp = stt + step ;
+
+          double sum = 0 ;
+
+          while (i < crv->mds.smp)
+          {
+               unsigned long smp_stt = (unsigned long) i * itv ;
+               unsigned long smp_stp = smp_stt + itv ;
+
+               unsigned long low = smp_stt > stt ? smp_stt : stt ;
+               unsigned long high = smp_stp < stp ? smp_stp : stp ;
+
+               if (high > low)
+                    sum += (double) crv->dpm[i].tim * (high - low) / itv ;
+
+               // a sample crossing the cell end is shared with the next cell
+
+               if (smp_stp > stp)
+                    break ;
+
+               i += 1 ;
+          }
+
+          grid[g] = sum / step ;
+     }
+}
+
+static void flat_crv (double *grid, double *out, unsigned int cnt)
+{
+     // least squares line removed, so the correlation follows
+     //  the regions and not the speed curve common to every dump
+
+     double avg_x = (cnt - 1) / 2.0 ;
+     double avg_y = 0 ;
+
+     for (unsigned int i = 0 ; i < cnt ; i++)
+          avg_y += grid[i] ;
+
+     avg_y /= cnt ;
+
+     double cov = 0 ;
+     double var = 0 ;
+
+     for (unsigned int i = 0 ; i < cnt ; i++)
+     {
+          cov += (i - avg_x) * (grid[i] - avg_y) ;
+          var += (i - avg_x) * (i - avg_x) ;
+     }
+
+     double slope = var > 0 ? cov / var : 0 ;
+
+     for (unsigned int i = 0 ; i < cnt ; i++)
+          out[i] = grid[i] - avg_y - slope * (i - avg_x) ;
+}
+
+KERNEL static void calc_fft (double *re, double *im, unsigned int size, bool inv)
+{
+     // iterative radix 2 transform, size being a power of two
+
+     for (unsigned int i = 1, j = 0 ; i < size ; i++)
+     {
+          unsigned int bit = size >> 1 ;
+
+          for ( ; j & bit ; bit >>= 1)
+               j ^= bit ;
+
+          j ^= bit ;
+
+          if (i < j)
+          {
+               double tmp = re[i] ; re[i] = re[j] ; re[j] = tmp ;
+               tmp = im[i] ; im[i] = im[j] ; im[j] = tmp ;
+          }
+     }
+
+     for (unsigned int len = 2 ; len <= size ; len <<= 1)
+     {
+          double ang = (inv ? 2 : -2) * M_PI / len ;
+          double w_re = cos (ang) ;
+          double w_im = sin (ang) ;
+
+          for (unsigned int i = 0 ; i < size ; i += len)
+          {
+               double t_re = 1 ;
+               double t_im = 0 ;
+
+               for (unsigned int k = 0 ; k < len / 2 ; k++)
+               {
+                    unsigned int a = i + k ;
+                    unsigned int b = i + k + len / 2 ;
+
+                    double b_re = re[b] * t_re - im[b] * t_im ;
+                    double b_im = re[b] * t_im + im[b] * t_re ;
+
+                    re[b] = re[a] - b_re ;
+                    im[b] = im[a] - b_im ;
+                    re[a] += b_re ;
+                    im[a] += b_im ;
+
+                    double n_re = t_re * w_re - t_im * w_im ;
+                    t_im = t_re * w_im + t_im * w_re ;
+                    t_re = n_re ;
+               }
+          }
+     }
+
+     if (inv)
+     {
+          for (unsigned int i = 0 ; i < size ; i++)
+          {
+               re[i] /= size ;
+               im[i] /= size ;
+          }
+     }
+}
+
+static signed int seek_lag (double *ra, double *ia, double *rb, double *ib, unsigned int size, unsigned int cnt)
+{
+     // product with the conjugate gives every circular correlation at once,
+     //  zero padding to twice the length keeps them linear
+
+     calc_fft (ra, ia, size, false) ;
+     calc_fft (rb, ib, size, false) ;
+
+     for (unsigned int i = 0 ; i < size ; i++)
+     {
+          double re = ra[i] * rb[i] + ia[i] * ib[i] ;
+          double im = ia[i] * rb[i] - ra[i] * ib[i] ;
+
+          ra[i] = re ;
+          ia[i] = im ;
+     }
+
+     calc_fft (ra, ia, size, true) ;
+
+     // offsets limited to a quarter of the grid, farther peaks
+     //  would rely on too few overlapping cells
+
+     signed int lim = cnt / 4 ;
+     signed int lag = 0 ;
+     double best = ra[0] ;
+
+     for (signed int k = - lim ; k <= lim ; k++)
+     {
+          double cor = ra[k < 0 ? size + k : k] ;
+
+          if (cor > best)
+               { best = cor ; lag = k ; }
+     }
+
+     return lag ;
+}
+
+static double calc_scr (double *ga, double *gb, unsigned int cnt, signed int lag)
+{
+     // correlation coefficient of the overlapping cells
+
+     unsigned int stt = lag < 0 ? - lag : 0 ;
+     unsigned int stp = lag > 0 ? cnt - lag : cnt ;
+     unsigned int num = stp - stt ;
+
+     double avg_a = 0 ;
+     double avg_b = 0 ;
+
+     for (unsigned int i = stt ; i < stp ; i++)
+     {
+          avg_a += ga[i+lag] ;
+          avg_b += gb[i] ;
+     }
+
+     avg_a /= num ;
+     avg_b /= num ;
+
+     double cov = 0 ;
+     double var_a = 0 ;
+     double var_b = 0 ;
+
+     for (unsigned int i = stt ; i < stp ; i++)
+     {
+          double dev_a = ga[i+lag] - avg_a ;
+          double dev_b = gb[i] - avg_b ;
+
+          cov += dev_a * dev_b ;
+          var_a += dev_a * dev_a ;
+          var_b += dev_b * dev_b ;
+     }
+
+     if (var_a == 0 || var_b == 0)
+          return 0 ;
+
+     return cov / sqrt (var_a * var_b) ;
+}
+
+static int save_aln (CRV *crv, double *ga, double *gb, unsigned int cnt, signed int lag, unsigned int step)
+{
+     // sectors of the first dump with both timings for that many sectors
+
+     char *aln_name = take_arn (&crv->arn, strlen (crv->name) + 5) ;
+     if (aln_name == NULL)
+          return 1 ;
+
+     strcpy (aln_name, crv->name) ;
+     strcat (aln_name, ".aln") ;
+
+     FILE *file = fopen (aln_name, "w") ;
+     if (file == NULL)
+          return 2 ;
+
+     unsigned int stt = lag < 0 ? - lag : 0 ;
+     unsigned int stp = lag > 0 ? cnt - lag : cnt ;
+
+     for (unsigned int i = stt ; i < stp ; i++)
+          fprintf (file, "%07ld\t%.1f\t%.1f\n", (long) (i + lag) * step, ga[i+lag] * step, gb[i] * step) ;
+
+     fclose (file) ;
+
+     return 0 ;
+}
+
+static int pair_crv (CRV *ref, CRV *crv, ARN *arn, OPT *opt)
+{
+     // coarsest interval of both dumps over the sectors both contain
+
+     unsigned int step = ref->mds.itv > crv->mds.itv ? ref->mds.itv : crv->mds.itv ;
+
+     unsigned long ref_len = (unsigned long) ref->mds.smp * ref->mds.itv ;
+     unsigned long crv_len = (unsigned long) crv->mds.smp * crv->mds.itv ;
+
+     if (ref->mds.sct < ref_len)
+          ref_len = ref->mds.sct ;
+     if (crv->mds.sct < crv_len)
+          crv_len = crv->mds.sct ;
+
+     unsigned int cnt = (ref_len < crv_len ? ref_len : crv_len) / step ;
+
+     if (cnt < 8)
+          return 1 ;
+
+     unsigned int size = 1 ;
+
+     while (size < 2 * cnt)
+          size <<= 1 ;
+
+     if (make_arn (arn, 4 * (cnt * sizeof (double) + ARN_ALIGN) + 4 * (size * sizeof (double) + ARN_ALIGN), opt->huge) != 0)
+          return 2 ;
+
+     double *ga = take_arn (arn, cnt * sizeof (double)) ;
+     double *gb = take_arn (arn, cnt * sizeof (double)) ;
+     double *fa = take_arn (arn, cnt * sizeof (double)) ;
+     double *fb = take_arn (arn, cnt * sizeof (double)) ;
+     double *ra = take_arn (arn, size * sizeof (double)) ;
+     double *ia = take_arn (arn, size * sizeof (double)) ;
+     double *rb = take_arn (arn, size * sizeof (double)) ;
+     double *ib = take_arn (arn, size * sizeof (double)) ;
+
+     grid_crv (ref, ga, step, cnt) ;
+     grid_crv (crv, gb, step, cnt) ;
+
+     // transforms work on copies of the flattened curves padded with zeros,
+     //  the score on the flattened curves alone, as the speed curve common
+     //  to every dump would correlate unrelated dumps as well
+
+     flat_crv (ga, fa, cnt) ;
+     flat_crv (gb, fb, cnt) ;
+
+     memcpy (ra, fa, cnt * sizeof (double)) ;
+     memcpy (rb, fb, cnt * sizeof (double)) ;
+
+     signed int lag = seek_lag (ra, ia, rb, ib, size, cnt) ;
+     double scr = calc_scr (fa, fb, cnt, lag) ;
+
+     printf ("%s.mds\t%s.mds\t%+ld sectors\t%.4f\n", ref->name, crv->name, (long) lag * step, scr) ;
+
+     if (save_aln (crv, ga, gb, cnt, lag, step) != 0)
+          return 3 ;
+
+     return 0 ;
+}
+
+int align (char **path, int count, OPT *opt)
+{
+     if (count < 2)
+          return 1 ;
+
+     CRV *crv = calloc (count, sizeof (CRV)) ;
+     if (crv == NULL)
+          return 2 ;
+
+     ARN arn = {0} ;
+
+     int error = 0 ;
+
+     // every dump is compared with the first one
+
+     for (int i = 0 ; i < count ; i++)
+     {
+          if (load_crv (path[i], &crv[i], opt) != 0)
+          {
+               fprintf (stderr, "%s\t-\tUnreadable\n", path[i]) ;
+               if (i == 0)
+                    { error = 3 ; goto quit ; }
+               continue ;
+          }
+
+          if (i == 0)
+               continue ;
+
+          switch (pair_crv (&crv[0], &crv[i], &arn, opt))
+          {
+               case 0 :
+                    break ;
+               case 1 :
+                    fprintf (stderr, "%s\t-\tNo common sectors\n", path[i]) ;
+                    break ;
+               default :
+                    error = 4 ;
+                    goto quit ;
+          }
+
+          free_arn (&crv[i].arn) ;
+     }
+
+     quit :
+
+     free_arn (&arn) ;
+
+     for (int i = 0 ; i < count ; i++)
+          free_arn (&crv[i].arn) ;
+
+     free (crv) ;
+
+     return error ;
+}
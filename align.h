@@ -0,0 +1,53 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef ALIGN_H
+# define ALIGN_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# include "type.h"
+# include "arena.h"
+# include "stream.h"
+# include "parse.h"
+
+typedef struct crv
+{
+     MDS mds ;
+     DPM *dpm ;
+     ARN arn ;
+     char *name ;
+}
+CRV ;
+
+static int load_crv (char *path, CRV *crv, OPT *opt) ;
+static void grid_crv (CRV *crv, double *grid, unsigned int step, unsigned int cnt) ;
+static void flat_crv (double *grid, double *out, unsigned int cnt) ;
+KERNEL static void calc_fft (double *re, double *im, unsigned int size, bool inv) ;
+static signed int seek_lag (double *ra, double *ia, double *rb, double *ib, unsigned int size, unsigned int cnt) ;
+static double calc_scr (double *ga, double *gb, unsigned int cnt, signed int lag) ;
+static int save_aln (CRV *crv, double *ga, double *gb, unsigned int cnt, signed int lag, unsigned int step) ;
+static int pair_crv (CRV *ref, CRV *crv, ARN *arn, OPT *opt) ;
+
+int align (char **path, int count, OPT *opt) ;
+
+# endif
@@ -0,0 +1,140 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "arena.h"
+# include "order.h"
+# include "split.h"
+# include "hist.h"
+# include "match.h"
+
+static unsigned char *map_arn (size_t size, bool huge)
+{
+     # if LINUX
+
+     void *base = MAP_FAILED ;
+
+     // explicit huge pages need a reserved pool, otherwise ask for transparent ones
+
+     if (huge)
+          base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0) ;
+
+     if (base == MAP_FAILED)
+     {
+          base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0) ;
+          if (base == MAP_FAILED)
+               return NULL ;
+
+          if (huge)
+               madvise (base, size, MADV_HUGEPAGE) ;
+     }
+
+     return base ;
+
+     # else
+
+     return malloc (size) ;
+
+     # endif
+}
+
+size_t size_arn (MDS *mds, OPT *opt, char *path)
+{
+     // names of the log, index, bitmap and vector chart files, samples, spike statistics,
+     //  the two chart curves, the segmentation, the histogram counters
+     //  of the analysis and of the chart, the median window and the matched filter
+
+     size_t size = 0 ;
+
+     size += 5 * (strlen (path) + 5 + ARN_ALIGN) ;
+     size += (mds->smp + 2 * DPM_PAD) * sizeof (DPM) + ARN_ALIGN ;
+     size += 200 * sizeof (SPK) + ARN_ALIGN ;
+     size += 2 * (mds->smp * 2 * sizeof (int) + ARN_ALIGN) ;
+     size += size_spl (mds) ;
+     size += 2 * (size_dis () + ARN_ALIGN) ;
+
+     if (opt->win != 0)
+          size += size_osw (opt->win) ;
+     if (opt->tpl != NULL)
+          size += size_mtc (mds) ;
+
+     return size ;
+}
+
+int make_arn (ARN *arn, size_t size, bool huge)
+{
+     // keep the current block when large enough
+
+     arn->used = 0 ;
+
+     if (arn->base != NULL && size <= arn->size)
+          return 0 ;
+
+     free_arn (arn) ;
+
+     huge = huge && size >= ARN_HUGE ;
+
+     if (huge)
+          size = (size + ARN_HUGE - 1) / ARN_HUGE * ARN_HUGE ;
+
+     arn->base = map_arn (size, huge) ;
+     if (arn->base == NULL)
+          return 1 ;
+
+     arn->size = size ;
+     arn->huge = huge ;
+
+     return 0 ;
+}
+
+void *take_arn (ARN *arn, size_t size)
+{
+     size_t start = (arn->used + ARN_ALIGN - 1) / ARN_ALIGN * ARN_ALIGN ;
+
+     if (arn->base == NULL || start + size > arn->size)
+          return NULL ;
+
+     arn->used = start + size ;
+
+     // blocks are handed out cleared like calloc
+
+     memset (arn->base + start, 0, size) ;
+
+     return arn->base + start ;
+}
+
+void rset_arn (ARN *arn)
+{
+     arn->used = 0 ;
+}
+
+void free_arn (ARN *arn)
+{
+     if (arn->base == NULL)
+          return ;
+
+     # if LINUX
+     munmap (arn->base, arn->size) ;
+     # else
+     free (arn->base) ;
+     # endif
+
+     arn->base = NULL ;
+     arn->size = 0 ;
+     arn->used = 0 ;
+}
@@ -0,0 +1,53 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef ARENA_H
+# define ARENA_H
+
+# include <stdbool.h>
+# include <stdlib.h>
+# include <string.h>
+
+# if LINUX
+# include <sys/mman.h>
+# endif
+
+# include "type.h"
+
+# define ARN_ALIGN 64
+# define ARN_HUGE (2 << 20)
+
+typedef struct arn
+{
+     unsigned char *base ;
+     size_t size ;
+     size_t used ;
+     bool huge ;
+}
+ARN ;
+
+static unsigned char *map_arn (size_t size, bool huge) ;
+
+size_t size_arn (MDS *mds, OPT *opt, char *path) ;
+int make_arn (ARN *arn, size_t size, bool huge) ;
+void *take_arn (ARN *arn, size_t size) ;
+void rset_arn (ARN *arn) ;
+void free_arn (ARN *arn) ;
+
+# endif
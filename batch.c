@@ -0,0 +1,344 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "batch.h"
+
+// analysis of many files without windows, the reads of up to depth files
+//  being queued at once to the kernel and analyzed as they complete,
+//  or read one after another with stdio where io_uring is missing
+
+static int done_mds (char *path, MDS *mds, DPM *dpm, ARN *arn, OPT *opt)
+{
+     char *name = NULL ;
+     SPK *spk = NULL ;
+     DSC dsc = {0} ;
+
+     // error codes of main for the metrics
+
+     if (get_name (path, &name, arn) != 0)
+          return fail_mds (path, 2, "Bad name", mds->smp) ;
+
+     unsigned long tick = time_met () ;
+
+     int state = eval_dpm (mds, dpm, &dsc, &spk, opt, arn) ;
+
+     span_met (MET_EVAL, tick) ;
+
+     if (state == 2 || state == 3)
+          return fail_mds (path, state == 2 ? 5 : 10, "Analysis failed", mds->smp) ;
+
+     tick = time_met () ;
+
+     if (save_log (mds, dpm, &dsc, spk, name, opt, arn) != 0)
+          return fail_mds (path, 6, "Log failed", mds->smp) ;
+
+     span_met (MET_SAVE, tick) ;
+
+     if (opt->res != NULL && save_res (opt->res, opt, name, mds, &dsc, spk) != 0)
+          return fail_mds (path, 6, "Results failed", mds->smp) ;
+
+     file_met (0, dsc.dpm_cat, mds->smp) ;
+
+     printf ("%s\t%s.log\n", path, name) ;
+
+     return 0 ;
+}
+
+static int fail_mds (char *path, int error, char *text, unsigned long smp)
+{
+     file_met (error, -1, smp) ;
+
+     printf ("%s\t-\t%s\n", path, text) ;
+
+     return error ;
+}
+
+static int read_std (char *path, ARN *arn, OPT *opt)
+{
+     MDS mds = {0} ;
+
+     unsigned long tick = time_met () ;
+
+     FILE *file = fopen (path, "rb") ;
+     if (file == NULL)
+          return fail_mds (path, 3, "No file", 0) ;
+
+     int error = read_mds (file, &mds) ;
+
+     if (error != 0)
+          { fclose (file) ; return fail_mds (path, 7, text_mds (error), 0) ; }
+
+     DPM *dpm = NULL ;
+
+     if (make_arn (arn, size_arn (&mds, opt, path), opt->huge) == 0)
+          dpm = make_dpm (arn, mds.smp) ;
+
+     if (dpm == NULL)
+          { fclose (file) ; return fail_mds (path, 4, "No memory", mds.smp) ; }
+
+     read_dpm (file, &mds, dpm) ;
+
+     fclose (file) ;
+
+     span_met (MET_PARSE, tick) ;
+     byte_met (MET_IN, base_dpm (&mds) + mds.smp * sizeof (unsigned int)) ;
+
+     return done_mds (path, &mds, dpm, arn, opt) ;
+}
+
+static int open_lot (LOT *lot, RNG *rng, unsigned long tag, char *path)
+{
+     // first read of a file, its header
+
+     lot->path = path ;
+     lot->step = 0 ;
+     lot->tick = time_met () ;
+
+     memset (lot->head, 0, sizeof (lot->head)) ;
+     memset (lot->tail, 0, sizeof (lot->tail)) ;
+     memset (&lot->mds, 0, sizeof (MDS)) ;
+
+     lot->fd = open (path, O_RDONLY) ;
+     if (lot->fd < 0)
+          return shut_lot (lot, 3, "No file") ;
+
+     if (push_rng (rng, lot->fd, lot->head, MDS_HEAD, 0, tag) != 0)
+          return shut_lot (lot, 4, "Queue full") ;
+
+     return 0 ;
+}
+
+static int next_lot (LOT *lot, RNG *rng, unsigned long tag, int res, OPT *opt)
+{
+     // one read of a file has completed, queue the following one
+     //  or analyze the file once its samples are in, 2 when the ring
+     //  cannot read at all
+
+     // kernels with io_uring but without its read request reject every read,
+     //  the file is then read with stdio as the following ones will be
+
+     if (res == -EINVAL)
+     {
+          close (lot->fd) ;
+          lot->fd = -1 ;
+
+          read_std (lot->path, &lot->arn, opt) ;
+
+          return 2 ;
+     }
+
+     if (res < 0)
+          return shut_lot (lot, 9, "Read failed") ;
+
+     if (lot->step == 0)
+     {
+          unsigned int off = tail_mds (lot->head) ;
+
+          lot->step = 1 ;
+
+          if (off != 0)
+          {
+               if (push_rng (rng, lot->fd, lot->tail, MDS_BACK + MDS_NEXT, off, tag) != 0)
+                    return shut_lot (lot, 4, "Queue full") ;
+               return 0 ;
+          }
+     }
+
+     if (lot->step == 1)
+     {
+          int error = view_mds (lot->head, lot->tail, &lot->mds) ;
+          if (error != 0)
+               return shut_lot (lot, 7, text_mds (error)) ;
+
+          // samples read straight into the arena, two zero words ahead
+
+          size_t raw_len = (lot->mds.smp + 2) * sizeof (unsigned int) ;
+
+          if (make_arn (&lot->arn, size_arn (&lot->mds, opt, lot->path) + raw_len + ARN_ALIGN, opt->huge) != 0)
+               return shut_lot (lot, 4, "No memory") ;
+
+          lot->raw = take_arn (&lot->arn, raw_len) ;
+          if (lot->raw == NULL)
+               return shut_lot (lot, 4, "No memory") ;
+
+          lot->raw[0] = 0 ;
+          lot->raw[1] = 0 ;
+
+          lot->step = 2 ;
+          lot->want = lot->mds.smp * sizeof (unsigned int) ;
+          lot->got = 0 ;
+
+          res = 0 ;
+     }
+
+     if (lot->step >= 2)
+     {
+          lot->got += res ;
+
+          // short reads go on from where they stopped, an empty read after
+          //  the first one being the end of the file
+
+          if (lot->got < lot->want && (lot->step == 2 || res > 0))
+          {
+               char *buf = (char *) (lot->raw + 2) + lot->got ;
+               unsigned long off = base_dpm (&lot->mds) + lot->got ;
+
+               lot->step = 3 ;
+
+               if (push_rng (rng, lot->fd, buf, lot->want - lot->got, off, tag) != 0)
+                    return shut_lot (lot, 4, "Queue full") ;
+               return 0 ;
+          }
+
+          memset ((char *) (lot->raw + 2) + lot->got, 0, lot->want - lot->got) ;
+
+          DPM *dpm = make_dpm (&lot->arn, lot->mds.smp) ;
+          if (dpm == NULL)
+               return shut_lot (lot, 4, "No memory") ;
+
+          conv_dpm (&lot->mds, dpm, lot->raw) ;
+
+          span_met (MET_PARSE, lot->tick) ;
+          byte_met (MET_IN, base_dpm (&lot->mds) + lot->got) ;
+
+          close (lot->fd) ;
+          lot->fd = -1 ;
+
+          done_mds (lot->path, &lot->mds, dpm, &lot->arn, opt) ;
+
+          return 1 ;
+     }
+
+     return 0 ;
+}
+
+static int shut_lot (LOT *lot, int error, char *text)
+{
+     fail_mds (lot->path, error, text, lot->mds.smp) ;
+
+     if (lot->fd >= 0)
+          close (lot->fd) ;
+
+     lot->fd = -1 ;
+
+     return 1 ;
+}
+
+int batch (char **path, int count, OPT *opt)
+{
+     char **list = NULL ;
+     unsigned int cnt = 0 ;
+
+     RNG rng = {0} ;
+     LOT *lot = NULL ;
+
+     int error = find_mds (path, count, &list, &cnt) ;
+     if (error != 0)
+          goto quit ;
+
+     unsigned int depth = opt->dep ? opt->dep : LOT_DEPTH ;
+     if (depth > cnt)
+          depth = cnt ;
+
+     // stdio fallback for kernels without io_uring
+
+     if (depth == 0 || make_rng (&rng, depth) != 0)
+     {
+          ARN arn = {0} ;
+
+          for (int i = 0 ; i < cnt ; i++)
+               read_std (list[i], &arn, opt) ;
+
+          free_arn (&arn) ;
+
+          goto quit ;
+     }
+
+     lot = calloc (depth, sizeof (LOT)) ;
+     if (lot == NULL)
+          { error = 3 ; goto quit ; }
+
+     unsigned int next = 0 ;
+     unsigned int busy = 0 ;
+     bool plain = false ;
+
+     for (unsigned int i = 0 ; i < depth ; i++)
+     {
+          // a file failing at once leaves its slot to the next one
+
+          while (next < cnt && open_lot (&lot[i], &rng, i, list[next++]) != 0) ;
+
+          if (lot[i].fd >= 0 && lot[i].path != NULL)
+               busy += 1 ;
+     }
+
+     while (busy > 0)
+     {
+          unsigned long tag = 0 ;
+          int res = 0 ;
+
+          if (wait_rng (&rng, &tag, &res) != 0)
+               { error = 4 ; break ; }
+
+          int state = next_lot (&lot[tag], &rng, tag, res, opt) ;
+
+          if (state == 0)
+               continue ;
+          if (state == 2)
+               plain = true ;
+
+          busy -= 1 ;
+
+          while (next < cnt && ! plain)
+          {
+               if (open_lot (&lot[tag], &rng, tag, list[next++]) == 0)
+                    { busy += 1 ; break ; }
+          }
+     }
+
+     // files left once the ring turned out unable to read
+
+     for (unsigned int i = 0 ; next < cnt ; i = (i + 1) % depth)
+          read_std (list[next++], &lot[i].arn, opt) ;
+
+     fflush (stdout) ;
+
+     quit :
+
+     if (lot != NULL)
+     {
+          for (unsigned int i = 0 ; i < depth ; i++)
+          {
+               if (lot[i].fd >= 0 && lot[i].path != NULL)
+                    close (lot[i].fd) ;
+               free_arn (&lot[i].arn) ;
+          }
+
+          free (lot) ;
+     }
+
+     free_rng (&rng) ;
+
+     for (int i = 0 ; i < cnt ; i++)
+          free (list[i]) ;
+     if (list != NULL)
+          free (list) ;
+
+     return error ;
+}
@@ -0,0 +1,69 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef BATCH_H
+# define BATCH_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+
+# include "type.h"
+# include "arena.h"
+# include "parse.h"
+# include "scan.h"
+# include "log.h"
+# include "fleet.h"
+# include "ring.h"
+# include "triage.h"
+# include "metric.h"
+
+// files read at once when no depth is given
+
+# define LOT_DEPTH 32
+
+typedef struct lot
+{
+     char *path ;
+     int fd ;
+     int step ;
+     unsigned char head[MDS_HEAD] ;
+     unsigned char tail[MDS_BACK + MDS_NEXT] ;
+     MDS mds ;
+     ARN arn ;
+     unsigned int *raw ;
+     unsigned long want ;
+     unsigned long got ;
+     unsigned long tick ;
+}
+LOT ;
+
+static int done_mds (char *path, MDS *mds, DPM *dpm, ARN *arn, OPT *opt) ;
+static int fail_mds (char *path, int error, char *text, unsigned long smp) ;
+static int read_std (char *path, ARN *arn, OPT *opt) ;
+static int open_lot (LOT *lot, RNG *rng, unsigned long tag, char *path) ;
+static int next_lot (LOT *lot, RNG *rng, unsigned long tag, int res, OPT *opt) ;
+static int shut_lot (LOT *lot, int error, char *text) ;
+
+int batch (char **path, int count, OPT *opt) ;
+
+# endif
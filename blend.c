@@ -0,0 +1,105 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "blend.h"
+
+// curves of many dumps of a disc in one chart, each dump reduced to the chart
+//  width as soon as it is read so that only the reduced curves are kept
+
+static int load_ovl (char *path, ARN *arn, OPT *opt, OVL *ovl)
+{
+     MDS mds = {0} ;
+
+     FILE *file = fopen (path, "rb") ;
+     if (file == NULL)
+          return 1 ;
+
+     if (read_mds (file, &mds) != 0)
+          { fclose (file) ; return 2 ; }
+
+     DPM *dpm = NULL ;
+
+     if (make_arn (arn, size_arn (&mds, opt, path), opt->huge) == 0)
+          dpm = make_dpm (arn, mds.smp) ;
+
+     if (dpm == NULL)
+          { fclose (file) ; return 3 ; }
+
+     read_dpm (file, &mds, dpm) ;
+
+     fclose (file) ;
+
+     return make_ovl (&mds, dpm, ovl) != 0 ? 4 : 0 ;
+}
+
+int blend (char **path, int count, OPT *opt)
+{
+     OVL *ovl = NULL ;
+     ARN arn = {0} ;
+     char *name = NULL ;
+
+     int error = 0 ;
+     int cnt = 0 ;
+
+     ovl = calloc (count, sizeof (OVL)) ;
+     if (ovl == NULL)
+          { error = 1 ; goto quit ; }
+
+     for (int i = 0 ; i < count ; i++)
+     {
+          int state = load_ovl (path[i], &arn, opt, &ovl[cnt]) ;
+
+          if (state != 0)
+               { printf ("%s\t-\tNot drawn\n", path[i]) ; continue ; }
+
+          printf ("%s\n", path[i]) ;
+          cnt += 1 ;
+     }
+
+     if (cnt == 0)
+          { error = 2 ; goto quit ; }
+
+     // named after the first dump
+
+     rset_arn (&arn) ;
+
+     if (get_name (path[0], &name, &arn) != 0)
+          { error = 3 ; goto quit ; }
+
+     char *name_ovl = take_arn (&arn, strlen (name) + 5) ;
+     if (name_ovl == NULL)
+          { error = 3 ; goto quit ; }
+
+     strcpy (name_ovl, name) ;
+     strcat (name_ovl, ".ovl") ;
+
+     // off-screen when no window can be opened
+
+     if (draw_ovl (ovl, cnt, name_ovl) && save_ovl (ovl, cnt, name_ovl))
+          error = 4 ;
+
+     quit :
+
+     free_arn (&arn) ;
+
+     if (ovl != NULL)
+          free (ovl) ;
+
+     return error ;
+}
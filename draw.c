@@ -19,7 +19,7 @@
 
 # include "draw.h"
 
-static int calc_tim_crv (MDS *mds, DPM *dpm, SDL_Point *timing, int smp_stt, int smp_stp)
+KERNEL static int calc_tim_crv (MDS *mds, DPM *dpm, SDL_Point *timing, int smp_stt, int smp_stp)
 {
      if (smp_stt >= mds->smp || smp_stp >= mds->smp)
           return 1 ;
@@ -38,7 +38,7 @@ static int calc_tim_crv (MDS *mds, DPM *dpm, SDL_Point *timing, int smp_stt, int
      return 0 ;
 }
 
-static int calc_var_crv (MDS *mds, DPM *dpm, SDL_Point *variation, int smp_stt, int smp_stp)
+KERNEL static int calc_var_crv (MDS *mds, DPM *dpm, SDL_Point *variation, int smp_stt, int smp_stp)
 {
      if (smp_stt >= mds->smp || smp_stp >= mds->smp)
           return 1 ;
@@ -57,37 +57,141 @@ static int calc_var_crv (MDS *mds, DPM *dpm, SDL_Point *variation, int smp_stt,
      return 0 ;
 }
 
-bool draw_dpm (MDS *mds, DPM *dpm, char *name)
+KERNEL static int calc_col (MDS *mds, DPM *dpm, SDL_Point *timing, SDL_Point *variation, int smp_stt, int smp_stp)
+{
+     if (smp_stt >= mds->smp || smp_stp >= mds->smp || mds->sct == 0)
+          return 0 ;
+
+     // same coordinates as the full curves, reduced to the lowest and highest
+     //  point of every column so that drawing no longer depends on the samples
+
+     double zoom_x = (double) mds->smp * mds->itv * OVL_COL / ((double) (smp_stp - smp_stt + 1) * mds->sct) ;
+     unsigned int base = dpm[0].tim ? dpm[0].tim : 1 ;
+
+     int cnt = 0 ;
+     int col = -1 ;
+     int tim_min = 0, tim_max = 0 ;
+     int var_min = 0, var_max = 0 ;
+
+     for (int i = smp_stt ; i <= smp_stp ; i++)
+     {
+          int x = (i - smp_stt + 1) * zoom_x ;
+          if (x > OVL_COL - 1)
+               x = OVL_COL - 1 ;
+
+          int tim = 480 - (dpm[i].tim * 480 / base) + 140 ;
+          int var = - dpm[i].var + 60 ;
+
+          if (x != col)
+          {
+               if (col >= 0)
+               {
+                    timing[cnt] = (SDL_Point) {col, tim_min} ;
+                    timing[cnt+1] = (SDL_Point) {col, tim_max} ;
+                    variation[cnt] = (SDL_Point) {col, var_min} ;
+                    variation[cnt+1] = (SDL_Point) {col, var_max} ;
+                    cnt += 2 ;
+               }
+
+               col = x ;
+               tim_min = tim_max = tim ;
+               var_min = var_max = var ;
+               continue ;
+          }
+
+          tim_min = tim < tim_min ? tim : tim_min ;
+          tim_max = tim > tim_max ? tim : tim_max ;
+          var_min = var < var_min ? var : var_min ;
+          var_max = var > var_max ? var : var_max ;
+     }
+
+     timing[cnt] = (SDL_Point) {col, tim_min} ;
+     timing[cnt+1] = (SDL_Point) {col, tim_max} ;
+     variation[cnt] = (SDL_Point) {col, var_min} ;
+     variation[cnt+1] = (SDL_Point) {col, var_max} ;
+
+     return cnt + 2 ;
+}
+
+static int calc_pan (MDS *mds, DPM *dpm, DIS *dis, ARN *arn)
+{
+     DSC dsc = {0} ;
+
+     // spread of each layer as in the log, the chart being drawn before the analysis
+
+     if (mds->lay == 2)
+          seek_brk (mds, dpm, &dsc) ;
+
+     if (dist_dpm (mds, dpm, &dsc, arn) != 0)
+          return 0 ;
+
+     memcpy (dis, dsc.dis, sizeof (dsc.dis)) ;
+
+     return mds->lay == 2 ? 2 : 1 ;
+}
+
+static bool rend_hst (SDL_Renderer *renderer, DIS *dis, int dis_cnt)
+{
+     // timing histograms on the left, variation ones on the right,
+     //  the second layer lighter and blended over the first
+
+     unsigned char color[2][2][3] = { { {255, 0, 0}, {255, 170, 0} }, { {0, 0, 255}, {0, 200, 255} } } ;
+
+     SDL_Rect bar[DIS_BIN] ;
+
+     int action = SDL_SetRenderDrawBlendMode (renderer, SDL_BLENDMODE_BLEND) ;
+     if (action != 0) return true ;
+
+     for (int c = 0 ; c < 2 ; c++)
+     {
+          unsigned int top = 1 ;
+
+          for (int l = 0 ; l < dis_cnt ; l++)
+          {
+               unsigned int *hst = c ? dis[l].var_hst : dis[l].tim_hst ;
+
+               for (int b = 0 ; b < DIS_BIN ; b++)
+                    top = hst[b] > top ? hst[b] : top ;
+          }
+
+          for (int l = 0 ; l < dis_cnt ; l++)
+          {
+               unsigned int *hst = c ? dis[l].var_hst : dis[l].tim_hst ;
+
+               for (int b = 0 ; b < DIS_BIN ; b++)
+               {
+                    int h = (unsigned long) hst[b] * 190 / top ;
+
+                    bar[b] = (SDL_Rect) {c * 320 + b * 10 + 1, 195 - h, 8, h} ;
+               }
+
+               action = SDL_SetRenderDrawColor (renderer, color[c][l][0], color[c][l][1], color[c][l][2], 160) ;
+               if (action != 0) return true ;
+               action = SDL_RenderFillRects (renderer, bar, DIS_BIN) ;
+               if (action != 0) return true ;
+          }
+     }
+
+     SDL_SetRenderDrawBlendMode (renderer, SDL_BLENDMODE_NONE) ;
+
+     return false ;
+}
+
+static bool rend_dpm (SDL_Renderer *renderer, MDS *mds, DPM *dpm, SDL_Point *timing, SDL_Point *variation, DIS *dis, int dis_cnt)
 {
-     SDL_Window *window = NULL ;
-     SDL_Renderer *renderer = NULL ;
      SDL_Texture *texture_1 = NULL ;
      SDL_Texture *texture_2 = NULL ;
-     SDL_Point *timing = NULL ;
-     SDL_Point *variation = NULL ;
-
-     /* initializing */
+     SDL_Texture *texture_3 = NULL ;
 
      int action = 0 ;
      bool error = false ;
 
-     action = SDL_Init (SDL_INIT_VIDEO) ;
-     if (action != 0) { error = true ; goto quit ; }
-
-     window = SDL_CreateWindow ("DPM SCN", 0, 0, 660, 720, SDL_WINDOW_SHOWN | SDL_WINDOW_BORDERLESS) ;
-     if (window == NULL) { error = true ; goto quit ; }
-     renderer = SDL_CreateRenderer (window, -1, SDL_RENDERER_SOFTWARE) ;
-     if (renderer == NULL) { error = true ; goto quit ; }
-
      texture_1 = SDL_CreateTexture (renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 640, 480) ;
      if (texture_1 == NULL) { error = true ; goto quit ; }
      texture_2 = SDL_CreateTexture (renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 640, 480) ;
      if (texture_2 == NULL) { error = true ; goto quit ; }
-
-     timing = malloc (mds->smp * sizeof (SDL_Point)) ;
-     if (timing == NULL) { error = true ; goto quit ; }
-     variation = malloc (mds->smp * sizeof (SDL_Point)) ;
-     if (variation == NULL) { error = true ; goto quit ; }
+     texture_3 = SDL_CreateTexture (renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 640, 200) ;
+     if (texture_3 == NULL) { error = true ; goto quit ; }
 
      /* drawing */
 
@@ -97,9 +201,10 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
           if (action != 0) { error = true ; goto quit ; }
           SDL_RenderClear (renderer) ;
 
-          SDL_Rect border_1 = {0, 0, 660, 720} ;
+          SDL_Rect border_1 = {0, 0, 660, DRW_H} ;
           SDL_Rect border_2 = {9, 9, 642, 442} ;
           SDL_Rect border_3 = {9, 459, 642, 252} ;
+          SDL_Rect border_4 = {9, 719, 642, 202} ;
 
           action = SDL_SetRenderDrawColor (renderer, 35, 35, 35, SDL_ALPHA_OPAQUE) ;
           if (action != 0) { error = true ; goto quit ; }
@@ -109,6 +214,8 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
           if (action != 0) { error = true ; goto quit ; }
           action = SDL_RenderDrawRect (renderer, &border_3) ;
           if (action != 0) { error = true ; goto quit ; }
+          action = SDL_RenderDrawRect (renderer, &border_4) ;
+          if (action != 0) { error = true ; goto quit ; }
 
      unsigned int count = 0 ;
 
@@ -156,6 +263,14 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
           action = SDL_RenderDrawLines (renderer, variation, count) ;
           if (action != 0) { error = true ; goto quit ; }
 
+     SDL_SetRenderTarget (renderer, texture_3) ;
+
+          action = SDL_SetRenderDrawColor (renderer, 0, 0, 0, SDL_ALPHA_OPAQUE) ;
+          if (action != 0) { error = true ; goto quit ; }
+          SDL_RenderClear (renderer) ;
+
+          if (rend_hst (renderer, dis, dis_cnt)) { error = true ; goto quit ; }
+
      /* rendering */
 
      SDL_SetRenderTarget (renderer, NULL) ;
@@ -164,15 +279,155 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
           SDL_Rect area_2 = {10, 10, 640, 440} ;
           SDL_Rect area_3 = {0, 0, 640, 250} ;
           SDL_Rect area_4 = {10, 460, 640, 250} ;
+          SDL_Rect area_5 = {0, 0, 640, 200} ;
+          SDL_Rect area_6 = {10, 720, 640, 200} ;
 
           SDL_RenderCopy (renderer, texture_1, &area_1, &area_2) ;
           SDL_RenderCopy (renderer, texture_2, &area_3, &area_4) ;
+          SDL_RenderCopy (renderer, texture_3, &area_5, &area_6) ;
 
           SDL_RenderPresent (renderer) ;
 
+     quit :
+
+     if (texture_3 != NULL)   SDL_DestroyTexture (texture_3) ;
+     if (texture_2 != NULL)   SDL_DestroyTexture (texture_2) ;
+     if (texture_1 != NULL)   SDL_DestroyTexture (texture_1) ;
+
+     return error ;
+}
+
+static bool rend_ovl (SDL_Renderer *renderer, OVL *ovl, int cnt)
+{
+     SDL_Texture *texture[2] = {NULL, NULL} ;
+
+     int action = 0 ;
+     bool error = false ;
+
+     for (int p = 0 ; p < 2 ; p++)
+     {
+          texture[p] = SDL_CreateTexture (renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, 640, 480) ;
+          if (texture[p] == NULL) { error = true ; goto quit ; }
+     }
+
+     /* drawing */
+
+     SDL_SetRenderTarget (renderer, NULL) ;
+
+          action = SDL_SetRenderDrawColor (renderer, 55, 55, 55, SDL_ALPHA_OPAQUE) ;
+          if (action != 0) { error = true ; goto quit ; }
+          SDL_RenderClear (renderer) ;
+
+          SDL_Rect border_1 = {0, 0, 660, 720} ;
+          SDL_Rect border_2 = {9, 9, 642, 442} ;
+          SDL_Rect border_3 = {9, 459, 642, 252} ;
+
+          action = SDL_SetRenderDrawColor (renderer, 35, 35, 35, SDL_ALPHA_OPAQUE) ;
+          if (action != 0) { error = true ; goto quit ; }
+          action = SDL_RenderDrawRect (renderer, &border_1) ;
+          if (action != 0) { error = true ; goto quit ; }
+          action = SDL_RenderDrawRect (renderer, &border_2) ;
+          if (action != 0) { error = true ; goto quit ; }
+          action = SDL_RenderDrawRect (renderer, &border_3) ;
+          if (action != 0) { error = true ; goto quit ; }
+
+     // one hue per dump around the color wheel, more transparent as dumps add up
+
+     unsigned char alpha = cnt > 1 ? 64 + 191 / cnt : SDL_ALPHA_OPAQUE ;
+
+     for (int p = 0 ; p < 2 ; p++)
+     {
+          SDL_SetRenderTarget (renderer, texture[p]) ;
+
+          action = SDL_SetRenderDrawColor (renderer, 0, 0, 0, SDL_ALPHA_OPAQUE) ;
+          if (action != 0) { error = true ; goto quit ; }
+          SDL_RenderClear (renderer) ;
+
+          action = SDL_SetRenderDrawBlendMode (renderer, SDL_BLENDMODE_BLEND) ;
+          if (action != 0) { error = true ; goto quit ; }
+
+          for (int i = 0 ; i < cnt ; i++)
+          {
+               float hue = 6.0f * i / cnt ;
+               float part = hue - (int) hue ;
+
+               unsigned char rise = 255 * part ;
+               unsigned char fall = 255 - rise ;
+
+               unsigned char rgb[6][3] = {
+                    {255, rise, 0}, {fall, 255, 0}, {0, 255, rise},
+                    {0, fall, 255}, {rise, 0, 255}, {255, 0, fall} } ;
+
+               unsigned char *color = rgb[(int) hue % 6] ;
+
+               action = SDL_SetRenderDrawColor (renderer, color[0], color[1], color[2], alpha) ;
+               if (action != 0) { error = true ; goto quit ; }
+               action = SDL_RenderDrawLines (renderer, ovl[i].tim[p], ovl[i].cnt[p]) ;
+               if (action != 0) { error = true ; goto quit ; }
+               action = SDL_RenderDrawLines (renderer, ovl[i].var[p], ovl[i].cnt[p]) ;
+               if (action != 0) { error = true ; goto quit ; }
+          }
+
+          SDL_SetRenderDrawBlendMode (renderer, SDL_BLENDMODE_NONE) ;
+     }
+
+     /* rendering */
+
+     SDL_SetRenderTarget (renderer, NULL) ;
+
+          SDL_Rect area_1 = {0, 0, 640, 440} ;
+          SDL_Rect area_2 = {10, 10, 640, 440} ;
+          SDL_Rect area_3 = {0, 0, 640, 250} ;
+          SDL_Rect area_4 = {10, 460, 640, 250} ;
+
+          SDL_RenderCopy (renderer, texture[0], &area_1, &area_2) ;
+          SDL_RenderCopy (renderer, texture[1], &area_3, &area_4) ;
+
+          SDL_RenderPresent (renderer) ;
+
+     quit :
+
+     if (texture[1] != NULL)  SDL_DestroyTexture (texture[1]) ;
+     if (texture[0] != NULL)  SDL_DestroyTexture (texture[0]) ;
+
+     return error ;
+}
+
+bool draw_dpm (MDS *mds, DPM *dpm, char *name, ARN *arn)
+{
+     SDL_Window *window = NULL ;
+     SDL_Renderer *renderer = NULL ;
+     SDL_Point *timing = NULL ;
+     SDL_Point *variation = NULL ;
+
+     /* initializing */
+
+     int action = 0 ;
+     bool error = false ;
+
+     action = SDL_Init (SDL_INIT_VIDEO) ;
+     if (action != 0) { error = true ; goto quit ; }
+
+     window = SDL_CreateWindow ("DPM SCN", 0, 0, 660, DRW_H, SDL_WINDOW_SHOWN | SDL_WINDOW_BORDERLESS) ;
+     if (window == NULL) { error = true ; goto quit ; }
+     renderer = SDL_CreateRenderer (window, -1, SDL_RENDERER_SOFTWARE) ;
+     if (renderer == NULL) { error = true ; goto quit ; }
+
+     timing = take_arn (arn, mds->smp * sizeof (SDL_Point)) ;
+     if (timing == NULL) { error = true ; goto quit ; }
+     variation = take_arn (arn, mds->smp * sizeof (SDL_Point)) ;
+     if (variation == NULL) { error = true ; goto quit ; }
+
+     DIS dis[2] = {0} ;
+     int dis_cnt = calc_pan (mds, dpm, dis, arn) ;
+
+     /* drawing */
+
+     if (rend_dpm (renderer, mds, dpm, timing, variation, dis, dis_cnt)) { error = true ; goto quit ; }
+
      /* exporting */
 
-     char *name_bmp = calloc (strlen (name) + 5, sizeof (char)) ;
+     char *name_bmp = take_arn (arn, strlen (name) + 5) ;
      if (name_bmp == NULL)
           return true ;
 
@@ -187,8 +442,6 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
      action = SDL_SaveBMP (surface, name_bmp) ;
      if (action != 0) { error = true ; goto quit ; }
 
-     free (name_bmp) ;
-
      /* waiting */
 
      SDL_Event event = {0} ;
@@ -221,10 +474,6 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
      quit :
 
      if (error == true)       SDL_Log ("%s\n", SDL_GetError()) ;
-     if (variation != NULL)   free (variation) ;
-     if (timing != NULL)      free (timing) ;
-     if (texture_2 != NULL)   SDL_DestroyTexture (texture_2) ;
-     if (texture_1 != NULL)   SDL_DestroyTexture (texture_1) ;
      if (renderer != NULL)    SDL_DestroyRenderer (renderer) ;
      if (window != NULL)      SDL_DestroyWindow (window) ; // also frees the attached surface
 
@@ -232,3 +481,244 @@ bool draw_dpm (MDS *mds, DPM *dpm, char *name)
 
      return error ;
 }
+
+static bool rend_srf (SDL_Surface **surface, SDL_Renderer **renderer, MDS *mds, DPM *dpm, ARN *arn)
+{
+     SDL_Point *timing = NULL ;
+     SDL_Point *variation = NULL ;
+
+     // same picture as draw_dpm rendered off-screen, no video device needed
+
+     *surface = SDL_CreateRGBSurfaceWithFormat (0, 660, DRW_H, 32, SDL_PIXELFORMAT_RGB888) ;
+     if (*surface == NULL) return true ;
+     *renderer = SDL_CreateSoftwareRenderer (*surface) ;
+     if (*renderer == NULL) return true ;
+
+     timing = take_arn (arn, mds->smp * sizeof (SDL_Point)) ;
+     if (timing == NULL) return true ;
+     variation = take_arn (arn, mds->smp * sizeof (SDL_Point)) ;
+     if (variation == NULL) return true ;
+
+     DIS dis[2] = {0} ;
+     int dis_cnt = calc_pan (mds, dpm, dis, arn) ;
+
+     return rend_dpm (*renderer, mds, dpm, timing, variation, dis, dis_cnt) ;
+}
+
+bool save_bmp (MDS *mds, DPM *dpm, char *name, ARN *arn)
+{
+     SDL_Surface *surface = NULL ;
+     SDL_Renderer *renderer = NULL ;
+     char *name_bmp = NULL ;
+
+     /* initializing */
+
+     int action = 0 ;
+     bool error = false ;
+
+     /* drawing */
+
+     if (rend_srf (&surface, &renderer, mds, dpm, arn)) { error = true ; goto quit ; }
+
+     /* exporting */
+
+     name_bmp = take_arn (arn, strlen (name) + 5) ;
+     if (name_bmp == NULL) { error = true ; goto quit ; }
+
+     strcpy (name_bmp, name) ;
+     strcat (name_bmp, ".bmp") ;
+
+     action = SDL_SaveBMP (surface, name_bmp) ;
+     if (action != 0) { error = true ; goto quit ; }
+
+     /* exiting */
+
+     quit :
+
+     if (error == true)       SDL_Log ("%s\n", SDL_GetError()) ;
+     if (renderer != NULL)    SDL_DestroyRenderer (renderer) ;
+     if (surface != NULL)     SDL_FreeSurface (surface) ;
+
+     return error ;
+}
+
+void *pack_bmp (MDS *mds, DPM *dpm, ARN *arn, size_t *len)
+{
+     SDL_Surface *surface = NULL ;
+     SDL_Renderer *renderer = NULL ;
+     SDL_RWops *stream = NULL ;
+     unsigned char *buf = NULL ;
+
+     /* initializing */
+
+     bool error = false ;
+
+     /* drawing */
+
+     if (rend_srf (&surface, &renderer, mds, dpm, arn)) { error = true ; goto quit ; }
+
+     /* exporting */
+
+     // room for the pixels and the file headers
+
+     size_t cap = surface->pitch * surface->h + 1024 ;
+
+     buf = malloc (cap) ;
+     if (buf == NULL) { error = true ; goto quit ; }
+     stream = SDL_RWFromMem (buf, cap) ;
+     if (stream == NULL) { error = true ; goto quit ; }
+
+     if (SDL_SaveBMP_RW (surface, stream, 0) != 0) { error = true ; goto quit ; }
+
+     *len = SDL_RWtell (stream) ;
+
+     /* exiting */
+
+     quit :
+
+     if (error == true)       SDL_Log ("%s\n", SDL_GetError()) ;
+     if (stream != NULL)      SDL_RWclose (stream) ;
+     if (renderer != NULL)    SDL_DestroyRenderer (renderer) ;
+     if (surface != NULL)     SDL_FreeSurface (surface) ;
+     if (error == true && buf != NULL) { free (buf) ; buf = NULL ; }
+
+     return buf ;
+}
+
+int make_ovl (MDS *mds, DPM *dpm, OVL *ovl)
+{
+     // whole disc, then the first samples as in the lower panel of draw_dpm
+
+     unsigned int count = mds->smp < 750 ? mds->smp : 750 ;
+
+     if (mds->smp == 0)
+          return 1 ;
+
+     ovl->cnt[0] = calc_col (mds, dpm, ovl->tim[0], ovl->var[0], 0, mds->smp - 1) ;
+     ovl->cnt[1] = calc_col (mds, dpm, ovl->tim[1], ovl->var[1], 0, count - 1) ;
+
+     return 0 ;
+}
+
+bool draw_ovl (OVL *ovl, int cnt, char *name)
+{
+     SDL_Window *window = NULL ;
+     SDL_Renderer *renderer = NULL ;
+     char *name_bmp = NULL ;
+
+     /* initializing */
+
+     int action = 0 ;
+     bool error = false ;
+
+     action = SDL_Init (SDL_INIT_VIDEO) ;
+     if (action != 0) { error = true ; goto quit ; }
+
+     window = SDL_CreateWindow ("DPM SCN", 0, 0, 660, 720, SDL_WINDOW_SHOWN | SDL_WINDOW_BORDERLESS) ;
+     if (window == NULL) { error = true ; goto quit ; }
+     renderer = SDL_CreateRenderer (window, -1, SDL_RENDERER_SOFTWARE) ;
+     if (renderer == NULL) { error = true ; goto quit ; }
+
+     /* drawing */
+
+     if (rend_ovl (renderer, ovl, cnt)) { error = true ; goto quit ; }
+
+     /* exporting */
+
+     name_bmp = malloc (strlen (name) + 5) ;
+     if (name_bmp == NULL) { error = true ; goto quit ; }
+
+     strcpy (name_bmp, name) ;
+     strcat (name_bmp, ".bmp") ;
+
+     SDL_Surface *surface = NULL ;
+
+     surface = SDL_GetWindowSurface (window) ;
+     if (surface == NULL) { error = true ; goto quit ; }
+
+     action = SDL_SaveBMP (surface, name_bmp) ;
+     if (action != 0) { error = true ; goto quit ; }
+
+     /* waiting */
+
+     SDL_Event event = {0} ;
+     bool execution = true ;
+
+     while (execution)
+     {
+          while (SDL_PollEvent (&event))
+          {
+               switch (event.type)
+               {
+                    case SDL_KEYDOWN :
+                         switch (event.key.keysym.sym)
+                         {
+                              case SDLK_ESCAPE :
+                                   execution = false ;
+                                   break ;
+                         }
+                         break ;
+
+                    case SDL_QUIT :
+                         execution = false ;
+                         break ;
+               }
+          }
+     }
+
+     /* exiting */
+
+     quit :
+
+     if (error == true)       SDL_Log ("%s\n", SDL_GetError()) ;
+     if (name_bmp != NULL)    free (name_bmp) ;
+     if (renderer != NULL)    SDL_DestroyRenderer (renderer) ;
+     if (window != NULL)      SDL_DestroyWindow (window) ;
+
+     SDL_Quit() ;
+
+     return error ;
+}
+
+bool save_ovl (OVL *ovl, int cnt, char *name)
+{
+     SDL_Surface *surface = NULL ;
+     SDL_Renderer *renderer = NULL ;
+     char *name_bmp = NULL ;
+
+     /* initializing */
+
+     int action = 0 ;
+     bool error = false ;
+
+     surface = SDL_CreateRGBSurfaceWithFormat (0, 660, 720, 32, SDL_PIXELFORMAT_RGB888) ;
+     if (surface == NULL) { error = true ; goto quit ; }
+     renderer = SDL_CreateSoftwareRenderer (surface) ;
+     if (renderer == NULL) { error = true ; goto quit ; }
+
+     /* drawing */
+
+     if (rend_ovl (renderer, ovl, cnt)) { error = true ; goto quit ; }
+
+     /* exporting */
+
+     name_bmp = malloc (strlen (name) + 5) ;
+     if (name_bmp == NULL) { error = true ; goto quit ; }
+
+     strcpy (name_bmp, name) ;
+     strcat (name_bmp, ".bmp") ;
+
+     action = SDL_SaveBMP (surface, name_bmp) ;
+     if (action != 0) { error = true ; goto quit ; }
+
+     /* exiting */
+
+     quit :
+
+     if (error == true)       SDL_Log ("%s\n", SDL_GetError()) ;
+     if (name_bmp != NULL)    free (name_bmp) ;
+     if (renderer != NULL)    SDL_DestroyRenderer (renderer) ;
+     if (surface != NULL)     SDL_FreeSurface (surface) ;
+
+     return error ;
+}
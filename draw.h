@@ -26,10 +26,41 @@
 # include <SDL.h>
 
 # include "type.h"
+# include "arena.h"
+# include "scan.h"
+# include "hist.h"
 
-static int calc_tim_crv (MDS *mds, DPM *dpm, SDL_Point *timing, int smp_stt, int smp_stp) ;
-static int calc_var_crv (MDS *mds, DPM *dpm, SDL_Point *variation, int smp_stt, int smp_stp) ;
+// height of the chart, curves then the spread of the samples
 
-bool draw_dpm (MDS *mds, DPM *dpm, char *name) ;
+# define DRW_H 930
+
+// curves of one dump in an overlay, reduced to the lowest and highest point
+//  of every chart column, whole disc then first samples
+
+# define OVL_COL 640
+
+typedef struct ovl
+{
+     SDL_Point tim[2][2 * OVL_COL] ;
+     SDL_Point var[2][2 * OVL_COL] ;
+     int cnt[2] ;
+}
+OVL ;
+
+KERNEL static int calc_tim_crv (MDS *mds, DPM *dpm, SDL_Point *timing, int smp_stt, int smp_stp) ;
+KERNEL static int calc_var_crv (MDS *mds, DPM *dpm, SDL_Point *variation, int smp_stt, int smp_stp) ;
+KERNEL static int calc_col (MDS *mds, DPM *dpm, SDL_Point *timing, SDL_Point *variation, int smp_stt, int smp_stp) ;
+static int calc_pan (MDS *mds, DPM *dpm, DIS *dis, ARN *arn) ;
+static bool rend_hst (SDL_Renderer *renderer, DIS *dis, int dis_cnt) ;
+static bool rend_dpm (SDL_Renderer *renderer, MDS *mds, DPM *dpm, SDL_Point *timing, SDL_Point *variation, DIS *dis, int dis_cnt) ;
+static bool rend_ovl (SDL_Renderer *renderer, OVL *ovl, int cnt) ;
+static bool rend_srf (SDL_Surface **surface, SDL_Renderer **renderer, MDS *mds, DPM *dpm, ARN *arn) ;
+
+bool draw_dpm (MDS *mds, DPM *dpm, char *name, ARN *arn) ;
+bool save_bmp (MDS *mds, DPM *dpm, char *name, ARN *arn) ;
+void *pack_bmp (MDS *mds, DPM *dpm, ARN *arn, size_t *len) ;
+int make_ovl (MDS *mds, DPM *dpm, OVL *ovl) ;
+bool draw_ovl (OVL *ovl, int cnt, char *name) ;
+bool save_ovl (OVL *ovl, int cnt, char *name) ;
 
 # endif
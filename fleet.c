@@ -0,0 +1,415 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "fleet.h"
+
+// results of many dumps gathered by drive and title
+//  into accumulators that merge exactly, whatever the order
+
+static const char magic[8] = "DPMAGG01" ;
+
+static const char *text[ACC_CNT] = {"variation", "curve", "errors", "deviation"} ;
+
+static unsigned int find_bkt (double value)
+{
+     // values are stored in hundredths, small ones exactly
+
+     unsigned long v = value > 0 ? value * 100 + 0.5 : 0 ;
+
+     if (v < 2 * ACC_SUB)
+          return v ;
+
+     unsigned int high = 63 - __builtin_clzl (v) ;
+     unsigned int shift = high - 4 ;
+     unsigned int bkt = (shift + 1) * ACC_SUB + (v >> shift) - ACC_SUB ;
+
+     return bkt < ACC_BKT ? bkt : ACC_BKT - 1 ;
+}
+
+static double calc_bkt (unsigned int bkt)
+{
+     // middle of the values of a bucket
+
+     if (bkt < 2 * ACC_SUB)
+          return bkt / 100.0 ;
+
+     unsigned int shift = bkt / ACC_SUB - 1 ;
+     unsigned long low = (unsigned long) (bkt % ACC_SUB + ACC_SUB) << shift ;
+
+     return (low + ((1ul << shift) - 1) / 2.0) / 100 ;
+}
+
+static void push_acc (ACC *acc, double value)
+{
+     // running mean and sum of squared deviations
+
+     acc->num += 1 ;
+
+     double dev = value - acc->avg ;
+
+     acc->avg += dev / acc->num ;
+     acc->sqr += dev * (value - acc->avg) ;
+
+     acc->bkt[find_bkt (value)] += 1 ;
+}
+
+static void join_acc (ACC *acc, ACC *add)
+{
+     if (add->num == 0)
+          return ;
+
+     unsigned long num = acc->num + add->num ;
+     double dev = add->avg - acc->avg ;
+
+     acc->avg += dev * add->num / num ;
+     acc->sqr += add->sqr + dev * dev * acc->num * add->num / num ;
+     acc->num = num ;
+
+     for (int i = 0 ; i < ACC_BKT ; i++)
+          acc->bkt[i] += add->bkt[i] ;
+}
+
+static double rank_acc (ACC *acc, double rank)
+{
+     // value below which the given fraction of the results lies
+
+     if (acc->num == 0)
+          return NAN ;
+
+     unsigned long goal = ceil (rank * acc->num) ;
+     unsigned long seen = 0 ;
+
+     if (goal == 0)
+          goal = 1 ;
+
+     for (int i = 0 ; i < ACC_BKT ; i++)
+     {
+          seen += acc->bkt[i] ;
+
+          if (seen >= goal)
+               return calc_bkt (i) ;
+     }
+
+     return calc_bkt (ACC_BKT - 1) ;
+}
+
+static GRP *find_grp (FLT *flt, char *drv, char *ttl)
+{
+     for (int i = 0 ; i < flt->cnt ; i++)
+     {
+          if (strcmp (flt->grp[i].drv, drv) == 0 && strcmp (flt->grp[i].ttl, ttl) == 0)
+               return &flt->grp[i] ;
+     }
+
+     if (flt->cnt == flt->max)
+     {
+          unsigned int max = flt->max ? flt->max * 2 : 16 ;
+
+          GRP *grp = realloc (flt->grp, max * sizeof (GRP)) ;
+          if (grp == NULL)
+               return NULL ;
+
+          flt->grp = grp ;
+          flt->max = max ;
+     }
+
+     GRP *grp = &flt->grp[flt->cnt] ;
+
+     memset (grp, 0, sizeof (GRP)) ;
+     snprintf (grp->drv, sizeof (grp->drv), "%s", drv) ;
+     snprintf (grp->ttl, sizeof (grp->ttl), "%s", ttl) ;
+
+     flt->cnt += 1 ;
+
+     return grp ;
+}
+
+static int load_res (FLT *flt, FILE *file)
+{
+     // drive, title, dump, then the measures, a dash when unknown
+
+     char line[512] ;
+
+     while (fgets (line, sizeof (line), file) != NULL)
+     {
+          char *field[3 + ACC_CNT] ;
+          int cnt = 0 ;
+
+          for (char *tok = strtok (line, "\t\n") ; tok != NULL && cnt < 3 + ACC_CNT ; tok = strtok (NULL, "\t\n"))
+               field[cnt++] = tok ;
+
+          if (cnt < 3 + ACC_CNT)
+               continue ;
+
+          GRP *grp = find_grp (flt, field[0], field[1]) ;
+          if (grp == NULL)
+               return 1 ;
+
+          for (int i = 0 ; i < ACC_CNT ; i++)
+          {
+               if (strcmp (field[3+i], "-") != 0)
+                    push_acc (&grp->acc[i], atof (field[3+i])) ;
+          }
+     }
+
+     return 0 ;
+}
+
+static int load_agg (FLT *flt, FILE *file)
+{
+     unsigned int cnt = 0 ;
+
+     if (fread (&cnt, sizeof (cnt), 1, file) != 1)
+          return 2 ;
+
+     GRP add ;
+
+     for (int i = 0 ; i < cnt ; i++)
+     {
+          if (fread (&add, sizeof (GRP), 1, file) != 1)
+               return 2 ;
+
+          add.drv[sizeof (add.drv) - 1] = 0 ;
+          add.ttl[sizeof (add.ttl) - 1] = 0 ;
+
+          GRP *grp = find_grp (flt, add.drv, add.ttl) ;
+          if (grp == NULL)
+               return 1 ;
+
+          for (int j = 0 ; j < ACC_CNT ; j++)
+               join_acc (&grp->acc[j], &add.acc[j]) ;
+     }
+
+     return 0 ;
+}
+
+static int save_agg (FLT *flt, char *path)
+{
+     FILE *file = fopen (path, "wb") ;
+     if (file == NULL)
+          return 1 ;
+
+     int error = 0 ;
+
+     if (fwrite (magic, sizeof (magic), 1, file) != 1)
+          error = 2 ;
+     else if (fwrite (&flt->cnt, sizeof (flt->cnt), 1, file) != 1)
+          error = 2 ;
+     else if (flt->cnt > 0 && fwrite (flt->grp, sizeof (GRP), flt->cnt, file) != flt->cnt)
+          error = 2 ;
+
+     if (fclose (file) != 0)
+          error = 2 ;
+
+     return error ;
+}
+
+static int comp_grp (const void *a, const void *b)
+{
+     const GRP *grp_a = a ;
+     const GRP *grp_b = b ;
+
+     int cmp = strcmp (grp_a->ttl, grp_b->ttl) ;
+     if (cmp != 0)
+          return cmp ;
+
+     // median variation first, the less the better
+
+     double med_a = rank_acc ((ACC *) &grp_a->acc[0], 0.5) ;
+     double med_b = rank_acc ((ACC *) &grp_b->acc[0], 0.5) ;
+
+     return (med_a > med_b) - (med_a < med_b) ;
+}
+
+static int show_rep (FLT *flt)
+{
+     // drives compared on the same title only, as values of other discs differ
+
+     qsort (flt->grp, flt->cnt, sizeof (GRP), comp_grp) ;
+
+     char drv[64][32] ;
+     double scr[64] = {0} ;
+     unsigned int num[64] = {0} ;
+     unsigned int drv_cnt = 0 ;
+
+     for (int i = 0 ; i < flt->cnt ; )
+     {
+          int stt = i ;
+
+          while (i < flt->cnt && strcmp (flt->grp[i].ttl, flt->grp[stt].ttl) == 0)
+               i += 1 ;
+
+          printf ("Title      \t %s\n\n", flt->grp[stt].ttl) ;
+
+          for (int j = stt ; j < i ; j++)
+          {
+               GRP *grp = &flt->grp[j] ;
+
+               printf ("%d\t%s\t%ld dumps\n", j - stt + 1, grp->drv, grp->acc[0].num) ;
+
+               for (int k = 0 ; k < ACC_CNT ; k++)
+               {
+                    ACC *acc = &grp->acc[k] ;
+
+                    if (acc->num == 0)
+                         continue ;
+
+                    double dev = acc->num > 1 ? sqrt (acc->sqr / (acc->num - 1)) : 0 ;
+
+                    printf ("\t%-10s\t avg = %.2f \t dev = %.2f \t p50 = %.2f \t p90 = %.2f\n",
+                            text[k], acc->avg, dev, rank_acc (acc, 0.5), rank_acc (acc, 0.9)) ;
+               }
+
+               // rank on this title scaled from 0 for the best to 1 for the worst
+
+               int d = 0 ;
+
+               while (d < drv_cnt && strcmp (drv[d], grp->drv) != 0)
+                    d += 1 ;
+
+               if (d == drv_cnt && drv_cnt < 64)
+                    snprintf (drv[drv_cnt++], sizeof (drv[0]), "%s", grp->drv) ;
+
+               if (d < drv_cnt)
+               {
+                    scr[d] += i - stt > 1 ? (double) (j - stt) / (i - stt - 1) : 0 ;
+                    num[d] += 1 ;
+               }
+          }
+
+          printf ("\n") ;
+     }
+
+     // drives ordered by their average place over the titles they read
+
+     unsigned int order[64] ;
+
+     for (int d = 0 ; d < drv_cnt ; d++)
+     {
+          scr[d] /= num[d] ;
+
+          int k = d ;
+
+          for ( ; k > 0 && scr[order[k-1]] > scr[d] ; k--)
+               order[k] = order[k-1] ;
+
+          order[k] = d ;
+     }
+
+     printf ("Ranking\n\n") ;
+
+     for (int k = 0 ; k < drv_cnt ; k++)
+          printf ("%d\t%s\t%.2f\t%d titles\n", k + 1, drv[order[k]], scr[order[k]], num[order[k]]) ;
+
+     return 0 ;
+}
+
+int save_res (char *path, OPT *opt, char *name, MDS *mds, DSC *dsc, SPK *spk)
+{
+     FILE *file = fopen (path, "a") ;
+     if (file == NULL)
+          return 1 ;
+
+     unsigned int var_sum = dsc->var_sum ;
+     float var_rat = dsc->var_rat ;
+
+     if (mds->lay == 2 && mds->itv != 50)
+     {
+          var_sum = dsc->lay_0_sum + dsc->lay_1_sum ;
+          var_rat = (dsc->lay_0_rat + dsc->lay_1_rat) / 2 ;
+     }
+
+     fprintf (file, "%s\t%s\t%s\t%d\t", opt->drv != NULL ? opt->drv : "-",
+              opt->tag != NULL ? opt->tag : name, name, var_sum) ;
+
+     // flat curves without variation have no ratio
+
+     if (isfinite (var_rat))
+          fprintf (file, "%.2f\t", var_rat) ;
+     else
+          fprintf (file, "-\t") ;
+
+     if (mds->itv == 50)
+          fprintf (file, "%d\t", dsc->err_cnt) ;
+     else
+          fprintf (file, "-\t") ;
+
+     // average spike length deviation, known for regular layouts only
+
+     if (spk != NULL && dsc->dpm_cat == 0)
+     {
+          unsigned char spr_cnt = dsc->dec_cnt / dsc->stp_cnt ;
+          float dev = 0 ;
+
+          for (int i = 0 ; i < spr_cnt ; i++)
+               dev += spk[i].dev ;
+
+          fprintf (file, "%.2f\n", dev / spr_cnt) ;
+     }
+     else fprintf (file, "-\n") ;
+
+     if (fclose (file) != 0)
+          return 2 ;
+
+     return 0 ;
+}
+
+int fleet (char **path, int count, OPT *opt)
+{
+     FLT flt = {0} ;
+
+     int error = 0 ;
+
+     // results files and partial aggregates can be mixed
+
+     for (int i = 0 ; i < count ; i++)
+     {
+          FILE *file = fopen (path[i], "rb") ;
+          if (file == NULL)
+               { error = 1 ; goto quit ; }
+
+          char head[sizeof (magic)] = {0} ;
+          size_t got = fread (head, 1, sizeof (head), file) ;
+
+          if (got == sizeof (head) && memcmp (head, magic, sizeof (magic)) == 0)
+               error = load_agg (&flt, file) ;
+          else
+          {
+               rewind (file) ;
+               error = load_res (&flt, file) ;
+          }
+
+          fclose (file) ;
+
+          if (error != 0)
+               { error = 2 ; goto quit ; }
+     }
+
+     if (opt->out != NULL && save_agg (&flt, opt->out) != 0)
+          { error = 3 ; goto quit ; }
+
+     show_rep (&flt) ;
+
+     quit :
+
+     if (flt.grp != NULL)
+          free (flt.grp) ;
+
+     return error ;
+}
@@ -0,0 +1,79 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef FLEET_H
+# define FLEET_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# include "type.h"
+
+// log linear buckets, 16 per power of two, about 6 % wide
+
+# define ACC_SUB 16
+# define ACC_BKT (40 * ACC_SUB)
+
+// measures kept per group : variation, curve ratio, errors, spike deviation
+
+# define ACC_CNT 4
+
+typedef struct acc
+{
+     unsigned long num ;
+     double avg ;
+     double sqr ;
+     unsigned long bkt[ACC_BKT] ;
+}
+ACC ;
+
+typedef struct grp
+{
+     char drv[32] ;
+     char ttl[64] ;
+     ACC acc[ACC_CNT] ;
+}
+GRP ;
+
+typedef struct flt
+{
+     GRP *grp ;
+     unsigned int cnt ;
+     unsigned int max ;
+}
+FLT ;
+
+static unsigned int find_bkt (double value) ;
+static double calc_bkt (unsigned int bkt) ;
+static void push_acc (ACC *acc, double value) ;
+static void join_acc (ACC *acc, ACC *add) ;
+static double rank_acc (ACC *acc, double rank) ;
+static GRP *find_grp (FLT *flt, char *drv, char *ttl) ;
+static int load_res (FLT *flt, FILE *file) ;
+static int load_agg (FLT *flt, FILE *file) ;
+static int save_agg (FLT *flt, char *path) ;
+static int comp_grp (const void *a, const void *b) ;
+static int show_rep (FLT *flt) ;
+
+int save_res (char *path, OPT *opt, char *name, MDS *mds, DSC *dsc, SPK *spk) ;
+int fleet (char **path, int count, OPT *opt) ;
+
+# endif
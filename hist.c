@@ -0,0 +1,185 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "hist.h"
+
+KERNEL static int fill_dis (DPM *dpm, int smp_stt, int smp_stp, unsigned int tim_lo, unsigned int *lane)
+{
+     unsigned int *tim_cnt = lane ;
+     unsigned int *var_cnt = lane + DIS_LANE * DIS_SPAN ;
+
+     unsigned short tim_bin[DIS_BLK] ;
+     unsigned short var_bin[DIS_BLK] ;
+
+     for (int i = smp_stt ; i <= smp_stp ; i += DIS_BLK)
+     {
+          int cnt = smp_stp - i + 1 < DIS_BLK ? smp_stp - i + 1 : DIS_BLK ;
+
+          // counters of a block computed without branches so that they vectorize
+
+          for (int k = 0 ; k < cnt ; k++)
+          {
+               int tim = (int) dpm[i+k].tim - (int) tim_lo ;
+               int var = dpm[i+k].var + DIS_SPAN / 2 ;
+
+               tim = tim < 0 ? 0 : tim ;
+               tim = tim > DIS_SPAN - 1 ? DIS_SPAN - 1 : tim ;
+               var = var < 0 ? 0 : var ;
+               var = var > DIS_SPAN - 1 ? DIS_SPAN - 1 : var ;
+
+               tim_bin[k] = tim ;
+               var_bin[k] = var ;
+          }
+
+          // neighbouring samples often share a value, each lane keeps its own
+          //  counters so that an increment never waits for the previous one
+
+          for (int k = 0 ; k < cnt ; k++)
+          {
+               tim_cnt[(k % DIS_LANE) * DIS_SPAN + tim_bin[k]] += 1 ;
+               var_cnt[(k % DIS_LANE) * DIS_SPAN + var_bin[k]] += 1 ;
+          }
+     }
+
+     // lanes summed into the first one
+
+     for (int l = 1 ; l < DIS_LANE ; l++)
+     {
+          for (int b = 0 ; b < DIS_SPAN ; b++)
+          {
+               tim_cnt[b] += tim_cnt[l * DIS_SPAN + b] ;
+               var_cnt[b] += var_cnt[l * DIS_SPAN + b] ;
+          }
+     }
+
+     return 0 ;
+}
+
+static int calc_qnt (unsigned int *cnt, unsigned int total, int *qnt)
+{
+     // nearest rank of the 1st, 50th and 99th percentiles
+
+     unsigned int rank[3] = {
+          (total * 1 + 99) / 100,
+          (total * 50 + 99) / 100,
+          (total * 99 + 99) / 100 } ;
+
+     unsigned int sum = 0 ;
+     int q = 0 ;
+
+     for (int b = 0 ; b < DIS_SPAN && q < 3 ; b++)
+     {
+          sum += cnt[b] ;
+
+          while (q < 3 && sum >= (rank[q] ? rank[q] : 1))
+               qnt[q++] = b ;
+     }
+
+     return 0 ;
+}
+
+static int pack_hst (unsigned int *cnt, int *qnt, unsigned int *hst, unsigned int *step)
+{
+     // bins of equal width from the 1st to the 99th percentile, the tails
+     //  being counted in the first and the last bin
+
+     *step = (qnt[2] - qnt[0] + DIS_BIN) / DIS_BIN ;
+
+     for (int b = 0 ; b < DIS_SPAN ; b++)
+     {
+          if (cnt[b] == 0)
+               continue ;
+
+          int bin = b < qnt[0] ? 0 : (b - qnt[0]) / (int) *step ;
+
+          if (bin > DIS_BIN - 1)
+               bin = DIS_BIN - 1 ;
+
+          hst[bin] += cnt[b] ;
+     }
+
+     return 0 ;
+}
+
+static int calc_dis (DPM *dpm, int smp_stt, int smp_stp, DIS *dis, unsigned int *lane)
+{
+     if (smp_stp < smp_stt)
+          return 1 ;
+
+     unsigned int total = smp_stp - smp_stt + 1 ;
+
+     // counters centered on the average timing, the raw values being cumulative
+
+     unsigned long raw = dpm[smp_stp].raw - (smp_stt > 0 ? dpm[smp_stt-1].raw : 0) ;
+     unsigned int avg = raw / total ;
+     unsigned int tim_lo = avg > DIS_SPAN / 2 ? avg - DIS_SPAN / 2 : 0 ;
+
+     memset (lane, 0, size_dis ()) ;
+
+     fill_dis (dpm, smp_stt, smp_stp, tim_lo, lane) ;
+
+     unsigned int *tim_cnt = lane ;
+     unsigned int *var_cnt = lane + DIS_LANE * DIS_SPAN ;
+
+     int tim_qnt[3] = {0} ;
+     int var_qnt[3] = {0} ;
+
+     calc_qnt (tim_cnt, total, tim_qnt) ;
+     calc_qnt (var_cnt, total, var_qnt) ;
+
+     pack_hst (tim_cnt, tim_qnt, dis->tim_hst, &dis->tim_step) ;
+     pack_hst (var_cnt, var_qnt, dis->var_hst, &dis->var_step) ;
+
+     for (int q = 0 ; q < 3 ; q++)
+     {
+          dis->tim_qnt[q] = tim_lo + tim_qnt[q] ;
+          dis->var_qnt[q] = var_qnt[q] - DIS_SPAN / 2 ;
+     }
+
+     dis->tim_lo = dis->tim_qnt[0] ;
+     dis->var_lo = dis->var_qnt[0] ;
+
+     return 0 ;
+}
+
+size_t size_dis (void)
+{
+     return 2 * DIS_LANE * DIS_SPAN * sizeof (unsigned int) ;
+}
+
+int dist_dpm (MDS *mds, DPM *dpm, DSC *dsc, ARN *arn)
+{
+     if (mds->smp == 0)
+          return 1 ;
+
+     unsigned int *lane = take_arn (arn, size_dis ()) ;
+     if (lane == NULL)
+          return 2 ;
+
+     // each layer on its own, the break found beforehand
+
+     if (mds->lay == 2 && dsc->brk_smp + 1 < mds->smp)
+     {
+          calc_dis (dpm, 0, dsc->brk_smp, &dsc->dis[0], lane) ;
+          calc_dis (dpm, dsc->brk_smp + 1, mds->smp - 1, &dsc->dis[1], lane) ;
+     }
+     else calc_dis (dpm, 0, mds->smp - 1, &dsc->dis[0], lane) ;
+
+     return 0 ;
+}
@@ -0,0 +1,45 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef HIST_H
+# define HIST_H
+
+# include <stdlib.h>
+# include <string.h>
+
+# include "type.h"
+# include "arena.h"
+
+// values counted one by one around the layer average, farther ones
+//  falling in the edge counters, private counters per lane and
+//  samples given their counter by blocks
+
+# define DIS_SPAN 2048
+# define DIS_LANE 8
+# define DIS_BLK 256
+
+KERNEL static int fill_dis (DPM *dpm, int smp_stt, int smp_stp, unsigned int tim_lo, unsigned int *lane) ;
+static int calc_qnt (unsigned int *cnt, unsigned int total, int *qnt) ;
+static int pack_hst (unsigned int *cnt, int *qnt, unsigned int *hst, unsigned int *step) ;
+static int calc_dis (DPM *dpm, int smp_stt, int smp_stp, DIS *dis, unsigned int *lane) ;
+
+size_t size_dis (void) ;
+int dist_dpm (MDS *mds, DPM *dpm, DSC *dsc, ARN *arn) ;
+
+# endif
@@ -50,14 +50,40 @@ static int save_dsc (FILE *file, MDS *mds, DPM *dpm, DSC *dsc)
           fprintf (file, "Curve      \t %.2f %%\n\n", dsc->var_rat) ;
      }
 
-     if (mds->itv == 50)
+     if (dsc->ada_win != 0)
+     {
+          fprintf (file, "Baseline   \t median of %d samples\n\n", dsc->ada_win) ;
+     }
+     else if (mds->itv == 50)
      {
           fprintf (file, "Accuracy   \t %d errors\n\n", dsc->err_cnt) ;
      }
 
+     fprintf (file, "Glitch     \t %d samples%s\n\n", dsc->glt_cnt, dsc->glt_off ? " left out" : "") ;
+
+     // spread of each layer, tails counted in the outer bins
+
+     for (int i = 0 ; i < (mds->lay == 2 ? 2 : 1) ; i++)
+     {
+          if (mds->lay == 2)
+               fprintf (file, "Layer      \t # %d\n", i) ;
+
+          save_dis (file, &dsc->dis[i]) ;
+     }
+
      fprintf (file, "Region     \t %d starts\n", dsc->stt_cnt) ;
      fprintf (file, "           \t %d stops\n\n", dsc->stp_cnt) ;
 
+     fprintf (file, "Segment    \t %d regions\n", dsc->seg_cnt) ;
+
+     for (int i = 0 ; i < dsc->seg_cnt ; i++)
+          fprintf (file, "           \t LBA = [%ld - %ld]\n", dsc->seg_stt[i], dsc->seg_stp[i]) ;
+
+     if (dsc->seg_cut != 0)
+          fprintf (file, "           \t %d more left out\n", dsc->seg_cut) ;
+
+     fprintf (file, "\n") ;
+
      fprintf (file, "Spike      \t %d increases\n", dsc->inc_cnt) ;
      fprintf (file, "           \t %d decreases\n\n", dsc->dec_cnt) ;
 
@@ -67,6 +93,24 @@ static int save_dsc (FILE *file, MDS *mds, DPM *dpm, DSC *dsc)
      return 0 ;
 }
 
+static int save_dis (FILE *file, DIS *dis)
+{
+     fprintf (file, "Quantile   \t timing p1 %d p50 %d p99 %d\n", dis->tim_qnt[0], dis->tim_qnt[1], dis->tim_qnt[2]) ;
+     fprintf (file, "           \t variation p1 %+d p50 %+d p99 %+d\n\n", dis->var_qnt[0], dis->var_qnt[1], dis->var_qnt[2]) ;
+
+     fprintf (file, "Histogram  \t timing from %d by %d\n           \t", dis->tim_lo, dis->tim_step) ;
+     for (int i = 0 ; i < DIS_BIN ; i++)
+          fprintf (file, " %d", dis->tim_hst[i]) ;
+
+     fprintf (file, "\n           \t variation from %+d by %d\n           \t", dis->var_lo, dis->var_step) ;
+     for (int i = 0 ; i < DIS_BIN ; i++)
+          fprintf (file, " %d", dis->var_hst[i]) ;
+
+     fprintf (file, "\n\n") ;
+
+     return 0 ;
+}
+
 static int save_reg (FILE *file, DSC *dsc)
 {
      if (dsc->dpm_cat == 1)
@@ -130,58 +174,617 @@ static int save_spk (FILE *file, DSC *dsc, SPK *spk)
      return 0 ;
 }
 
-static int save_dpm (FILE *file, MDS *mds, DPM *dpm, DSC *dsc)
+static unsigned int same_mtc (MDS *mds, unsigned long *rul, unsigned char rul_cnt, unsigned long *mtc, unsigned char mtc_cnt)
+{
+     // events of both detectors at most one sample apart
+
+     unsigned int same = 0 ;
+     int j = 0 ;
+
+     for (int i = 0 ; i < mtc_cnt ; i++)
+     {
+          while (j < rul_cnt && rul[j] + mds->itv < mtc[i])
+               j += 1 ;
+
+          if (j < rul_cnt && rul[j] <= mtc[i] + mds->itv)
+               { same += 1 ; j += 1 ; }
+     }
+
+     return same ;
+}
+
+static int list_mtc (FILE *file, MDS *mds, unsigned long *rul, unsigned char rul_cnt,
+                     unsigned long *mtc, unsigned char mtc_cnt, char *kind)
+{
+     // both lists merged by sector, events one sample apart on the same line
+
+     int i = 0 ;
+     int j = 0 ;
+
+     while (i < rul_cnt || j < mtc_cnt)
+     {
+          if (i < rul_cnt && j < mtc_cnt && rul[i] <= mtc[j] + mds->itv && mtc[j] <= rul[i] + mds->itv)
+               { fprintf (file, "           \t %07ld \t %s \t both\n", rul[i], kind) ; i += 1 ; j += 1 ; }
+          else if (j == mtc_cnt || (i < rul_cnt && rul[i] < mtc[j]))
+               { fprintf (file, "           \t %07ld \t %s \t rules\n", rul[i], kind) ; i += 1 ; }
+          else
+               { fprintf (file, "           \t %07ld \t %s \t matched\n", mtc[j], kind) ; j += 1 ; }
+     }
+
+     return 0 ;
+}
+
+static int save_mtc (FILE *file, MDS *mds, DSC *dsc)
+{
+     if (dsc->mtc_run == 0)
+          return 1 ;
+
+     fprintf (file, "Matched    \t templates of %d increases and %d decreases\n", dsc->tpl_cnt[0], dsc->tpl_cnt[1]) ;
+
+     if (dsc->mtc_run == 1)
+     {
+          fprintf (file, "           \t no template for this interval yet\n\n") ;
+          return 0 ;
+     }
+
+     fprintf (file, "           \t %d increases and %d decreases, %d and %d found by the rules\n",
+              dsc->mtc_inc_cnt, dsc->mtc_dec_cnt,
+              same_mtc (mds, dsc->inc_lba, dsc->inc_cnt, dsc->mtc_inc, dsc->mtc_inc_cnt),
+              same_mtc (mds, dsc->dec_lba, dsc->dec_cnt, dsc->mtc_dec, dsc->mtc_dec_cnt)) ;
+     fprintf (file, "           \t %.3f ms against %.3f ms for the rules\n\n", dsc->mtc_tim / 1e6, dsc->spk_tim / 1e6) ;
+
+     list_mtc (file, mds, dsc->inc_lba, dsc->inc_cnt, dsc->mtc_inc, dsc->mtc_inc_cnt, "increase") ;
+     list_mtc (file, mds, dsc->dec_lba, dsc->dec_cnt, dsc->mtc_dec, dsc->mtc_dec_cnt, "decrease") ;
+
+     fprintf (file, "\n") ;
+
+     return 0 ;
+}
+
+static unsigned int list_evt (MDS *mds, DSC *dsc, unsigned int *evt)
+{
+     // samples of the spikes and of the layer break, in order
+
+     unsigned int cnt = 0 ;
+
+     for (int i = 0 ; i < dsc->inc_cnt ; i++)
+          evt[cnt++] = dsc->inc_lba[i] / mds->itv - 1 ;
+     for (int i = 0 ; i < dsc->dec_cnt ; i++)
+          evt[cnt++] = dsc->dec_lba[i] / mds->itv - 1 ;
+
+     if (mds->lay == 2 && ! mds->cd)
+          evt[cnt++] = dsc->brk_smp ;
+
+     for (int i = 1 ; i < cnt ; i++)
+     {
+          unsigned int cur = evt[i] ;
+          int j = i ;
+
+          for ( ; j > 0 && evt[j-1] > cur ; j--)
+               evt[j] = evt[j-1] ;
+
+          evt[j] = cur ;
+     }
+
+     return cnt ;
+}
+
+# if LINUX
+
+static void *form_chk (void *arg)
+{
+     CHK *chk = arg ;
+
+     MDS *mds = chk->mds ;
+     DPM *dpm = chk->dpm ;
+     DSC *dsc = chk->dsc ;
+
+     FILE *file = open_memstream (&chk->buf, &chk->len) ;
+     if (file == NULL)
+          { chk->fail = true ; return NULL ; }
+
+     unsigned long sector = (unsigned long) chk->stt * mds->itv ;
+     unsigned char inc_num = chk->inc_num ;
+     unsigned char dec_num = chk->dec_num ;
+     char mark = chk->mark ;
+
+     // same lines as save_dpm, index offsets relative to the chunk
+
+     for (unsigned int i = chk->stt ; i < chk->stp ; i++)
+     {
+          sector += mds->itv ;
+
+          if (chk->entry != NULL && i % LOG_STEP == 0)
+          {
+               chk->entry[chk->entry_cnt][0] = sector - mds->itv ;
+               chk->entry[chk->entry_cnt][1] = ftell (file) ;
+               chk->entry_cnt += 1 ;
+          }
+
+          if (inc_num < dsc->inc_cnt && sector == dsc->inc_lba[inc_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   INCREASE # %d\n", inc_num + 1) ;
+               mark = '>' ;
+               inc_num += 1 ;
+          }
+          else if (dec_num < dsc->dec_cnt && sector == dsc->dec_lba[dec_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   DECREASE # %d\n", dec_num + 1) ;
+               mark = '|' ;
+               dec_num += 1 ;
+          }
+
+          fprintf (file, "[%07ld - %07ld] %08ld %d %+d \t %c\n",
+                   sector - mds->itv, sector, dpm[i].raw, dpm[i].tim, dpm[i].var, mark) ;
+     }
+
+     if (fclose (file) != 0)
+          chk->fail = true ;
+
+     return NULL ;
+}
+
+static int save_par (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, FILE *index, unsigned int jobs)
+{
+     unsigned int chk_cnt = (mds->smp + LOG_CHK - 1) / LOG_CHK ;
+
+     // one thread per core unless the caller chooses
+
+     if (jobs == 0)
+          jobs = sysconf (_SC_NPROCESSORS_ONLN) ;
+
+     if (jobs > chk_cnt)
+          jobs = chk_cnt ;
+     if (jobs < 2)
+          return 1 ;
+
+     CHK *chk = calloc (chk_cnt, sizeof (CHK)) ;
+     pthread_t *thread = calloc (jobs, sizeof (pthread_t)) ;
+
+     if (chk == NULL || thread == NULL)
+          { free (chk) ; free (thread) ; return 1 ; }
+
+     // state of the event marks where each chunk begins, replayed from the start
+     //  so that every chunk prints exactly what the serial loop would
+
+     unsigned long sector = 0 ;
+     unsigned char inc_num = 0 ;
+     unsigned char dec_num = 0 ;
+     char mark = '|' ;
+
+     for (unsigned int i = 0 ; i < mds->smp ; i++)
+     {
+          if (i % LOG_CHK == 0)
+          {
+               CHK *cur = &chk[i / LOG_CHK] ;
+
+               cur->mds = mds ;
+               cur->dpm = dpm ;
+               cur->dsc = dsc ;
+               cur->stt = i ;
+               cur->stp = i + LOG_CHK < mds->smp ? i + LOG_CHK : mds->smp ;
+               cur->inc_num = inc_num ;
+               cur->dec_num = dec_num ;
+               cur->mark = mark ;
+          }
+
+          sector += mds->itv ;
+
+          if (inc_num < dsc->inc_cnt && sector == dsc->inc_lba[inc_num])
+               { mark = '>' ; inc_num += 1 ; }
+          else if (dec_num < dsc->dec_cnt && sector == dsc->dec_lba[dec_num])
+               { mark = '|' ; dec_num += 1 ; }
+     }
+
+     // rounds of one chunk per thread, written in order before the next round
+     //  so that memory stays bounded by the round and not the log, through
+     //  the stream itself so that memory streams work and its offsets stay right
+
+     long base = ftell (file) ;
+     int error = 0 ;
+
+     for (unsigned int k = 0 ; k < chk_cnt && error == 0 ; k += jobs)
+     {
+          unsigned int cnt = chk_cnt - k < jobs ? chk_cnt - k : jobs ;
+          unsigned int started = 0 ;
+
+          for (unsigned int j = 0 ; j < cnt ; j++)
+          {
+               CHK *cur = &chk[k+j] ;
+
+               if (index != NULL)
+               {
+                    cur->entry = malloc ((LOG_CHK / LOG_STEP + 1) * sizeof (*cur->entry)) ;
+                    if (cur->entry == NULL)
+                         { cur->fail = true ; continue ; }
+               }
+
+               if (pthread_create (&thread[j], NULL, form_chk, cur) != 0)
+                    form_chk (cur) ;
+               else started |= 1u << j ;
+          }
+
+          for (unsigned int j = 0 ; j < cnt ; j++)
+          {
+               if (started & (1u << j))
+                    pthread_join (thread[j], NULL) ;
+
+          }
+
+          // a chunk that could not be formatted or written fails the whole log
+
+          for (unsigned int j = 0 ; j < cnt && error == 0 ; j++)
+          {
+               CHK *cur = &chk[k+j] ;
+
+               if (cur->fail || (cur->len > 0 && fwrite (cur->buf, cur->len, 1, file) != 1))
+                    { error = 2 ; break ; }
+
+               for (unsigned int e = 0 ; e < cur->entry_cnt ; e++)
+               {
+                    unsigned long entry[2] = {cur->entry[e][0], cur->entry[e][1] + base} ;
+                    fwrite (entry, sizeof (entry), 1, index) ;
+               }
+
+               base += cur->len ;
+          }
+
+          for (unsigned int j = 0 ; j < cnt ; j++)
+          {
+               free (chk[k+j].buf) ;
+               free (chk[k+j].entry) ;
+          }
+     }
+
+     free (thread) ;
+     free (chk) ;
+
+     return error ;
+}
+
+# endif
+
+static int save_dpm (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, bool sparse, FILE *index, unsigned int jobs)
 {
+     # if LINUX
+
+     // full logs of large files are formatted by several threads, the
+     //  serial loop taking over only when nothing was written yet
+
+     if (! sparse && mds->smp >= 2 * LOG_CHK)
+     {
+          int state = save_par (file, mds, dpm, dsc, index, jobs) ;
+
+          if (state != 1)
+               return state ;
+     }
+
+     # endif
+
      unsigned long sector = 0 ;
      unsigned char inc_num = 0 ;
      unsigned char dec_num = 0 ;
      char mark = '|' ;
 
+     unsigned int evt[2 * 200 + 1] ;
+     unsigned int evt_cnt = sparse ? list_evt (mds, dsc, evt) : 0 ;
+     unsigned int evt_num = 0 ;
+
+     unsigned int line = 0 ;
+     int last = -1 ;
+
      for (int i = 0 ; i < mds->smp ; i++)
      {
           sector += mds->itv ;
 
+          // sparse logs keep the samples close to a spike or to the break,
+          //  windows being separated by an empty line
+
+          bool show = true ;
+
+          if (sparse)
+          {
+               while (evt_num < evt_cnt && evt[evt_num] + LOG_WIN < i)
+                    evt_num += 1 ;
+
+               show = evt_num < evt_cnt && evt[evt_num] <= i + LOG_WIN ;
+
+               if (show && last >= 0 && last != i - 1)
+                    fprintf (file, "\n") ;
+          }
+
+          // index entries point at the first line of a window and then every few lines
+
+          if (show && index != NULL && (last != i - 1 || line % LOG_STEP == 0))
+          {
+               unsigned long entry[2] = {sector - mds->itv, ftell (file)} ;
+               fwrite (entry, sizeof (entry), 1, index) ;
+          }
+
           if (inc_num < dsc->inc_cnt && sector == dsc->inc_lba[inc_num])
           {
-               fprintf (file, "\t\t\t\t\t\t\t\t   INCREASE # %d\n", inc_num + 1) ;
+               if (show)
+                    fprintf (file, "\t\t\t\t\t\t\t\t   INCREASE # %d\n", inc_num + 1) ;
                mark = '>' ;
                inc_num += 1 ;
           }
           else if (dec_num < dsc->dec_cnt && sector == dsc->dec_lba[dec_num])
           {
-               fprintf (file, "\t\t\t\t\t\t\t\t   DECREASE # %d\n", dec_num + 1) ;
+               if (show)
+                    fprintf (file, "\t\t\t\t\t\t\t\t   DECREASE # %d\n", dec_num + 1) ;
                mark = '|' ;
                dec_num += 1 ;
           }
 
+          if (! show)
+               continue ;
+
           fprintf (file, "[%07ld - %07ld] %08ld %d %+d \t %c\n",
                    sector - mds->itv, sector, dpm[i].raw, dpm[i].tim, dpm[i].var, mark) ;
+
+          line += 1 ;
+          last = i ;
      }
 
-     return 0 ;
+     return ferror (file) ? 2 : 0 ;
 }
 
-int save_log (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name)
+static char *make_ext (char *name, char *ext, ARN *arn)
 {
-     char *name_log = calloc (strlen (name) + 5, sizeof (char)) ;
+     char *path = take_arn (arn, strlen (name) + 5) ;
+     if (path == NULL)
+          return NULL ;
+
+     strcpy (path, name) ;
+     strcat (path, ext) ;
+
+     return path ;
+}
+
+int save_txt (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, bool sparse, FILE *index, unsigned int jobs)
+{
+     // whole log body, also written to memory by the self-check,
+     //  sample lines on the given number of threads, 0 for one per core
+
+     save_dsc (file, mds, dpm, dsc) ;
+     save_reg (file, dsc) ;
+     save_spk (file, dsc, spk) ;
+     save_mtc (file, mds, dsc) ;
+
+     return save_dpm (file, mds, dpm, dsc, sparse, index, jobs) ;
+}
+
+int save_log (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name, OPT *opt, ARN *arn)
+{
+     FILE *index = NULL ;
+
+     char *name_log = make_ext (name, ".log", arn) ;
      if (name_log == NULL)
           return 1 ;
 
-     strcpy (name_log, name) ;
-     strcat (name_log, ".log") ;
-
      FILE *file = fopen (name_log, "w") ;
      if (file == NULL)
           return 2 ;
 
-     free (name_log) ;
+     // sidecar index of the sample lines, sector and byte offset pairs
+
+     if (opt->index)
+     {
+          char *name_idx = make_ext (name, ".idx", arn) ;
+          if (name_idx != NULL)
+               index = fopen (name_idx, "wb") ;
+          if (index == NULL)
+               { fclose (file) ; return 2 ; }
+
+          fwrite (LOG_MAGIC, 8, 1, index) ;
+     }
+
+     int state = save_txt (file, mds, dpm, dsc, spk, opt->sparse, index, 0) ;
+
+     byte_met (MET_OUT, ftell (file)) ;
+     if (fclose (file) != 0)
+          state = 2 ;
+
+     if (index != NULL)
+          { byte_met (MET_OUT, ftell (index)) ; fclose (index) ; }
+
+     if (state != 0)
+          return 4 ;
+
+     // vector chart for reports, beside the log
+
+     if (opt->svg)
+     {
+          char *name_svg = make_ext (name, ".svg", arn) ;
+          if (name_svg == NULL)
+               return 1 ;
+
+          FILE *chart = fopen (name_svg, "w") ;
+          if (chart == NULL)
+               return 2 ;
+
+          state = save_svg (chart, mds, dpm, dsc) ;
+
+          byte_met (MET_OUT, ftell (chart)) ;
+          fclose (chart) ;
+
+          if (state != 0)
+               return 3 ;
+     }
+
+     return 0 ;
+}
+
+int seek_log (char *path, unsigned long sector)
+{
+     FILE *file = NULL ;
+     FILE *index = NULL ;
+     char *name_idx = NULL ;
+     unsigned long (*entry)[2] = NULL ;
+
+     int error = 0 ;
+
+     unsigned int len = strlen (path) ;
+
+     if (len < 4 || strcmp (path + len - 4, ".log") != 0)
+          { error = 1 ; goto quit ; }
+
+     name_idx = malloc (len + 1) ;
+     if (name_idx == NULL)
+          { error = 4 ; goto quit ; }
+
+     strcpy (name_idx, path) ;
+     strcpy (name_idx + len - 4, ".idx") ;
+
+     file = fopen (path, "r") ;
+     index = fopen (name_idx, "rb") ;
+
+     if (file == NULL || index == NULL)
+          { error = 2 ; goto quit ; }
+
+     char magic[8] = {0} ;
+
+     fseek (index, 0, SEEK_END) ;
+     long size = ftell (index) - 8 ;
+     fseek (index, 0, SEEK_SET) ;
+
+     if (size < 0 || fread (magic, 8, 1, index) != 1 || memcmp (magic, LOG_MAGIC, 8) != 0)
+          { error = 3 ; goto quit ; }
+
+     unsigned long cnt = size / sizeof (*entry) ;
+
+     entry = malloc (cnt * sizeof (*entry) + 1) ;
+     if (entry == NULL)
+          { error = 4 ; goto quit ; }
+
+     if (fread (entry, sizeof (*entry), cnt, index) != cnt)
+          { error = 3 ; goto quit ; }
+
+     // last entry starting at or before the sector
+
+     unsigned long low = 0 ;
+     unsigned long high = cnt ;
+
+     while (high - low > 1)
+     {
+          unsigned long mid = (low + high) / 2 ;
+
+          if (entry[mid][0] <= sector)
+               low = mid ;
+          else
+               high = mid ;
+     }
+
+     if (cnt > 0)
+          fseek (file, entry[low][1], SEEK_SET) ;
+
+     // lines before the one holding the sector are kept until it is found
+
+     char line[LOG_WIN][160] ;
+     unsigned int kept = 0 ;
+     int after = -1 ;
+
+     while (after < LOG_WIN && fgets (line[kept % LOG_WIN], sizeof (line[0]), file) != NULL)
+     {
+          unsigned long stt = 0 ;
+          unsigned long stp = 0 ;
+
+          if (after < 0)
+          {
+               if (sscanf (line[kept % LOG_WIN], "[%ld - %ld]", &stt, &stp) == 2 && stp > sector)
+               {
+                    after = 0 ;
+
+                    unsigned int first = kept >= LOG_WIN / 2 ? kept - LOG_WIN / 2 : 0 ;
+
+                    for (unsigned int k = first ; k < kept ; k++)
+                         fputs (line[k % LOG_WIN], stdout) ;
+               }
+               else
+               {
+                    kept += 1 ;
+                    continue ;
+               }
+          }
+
+          fputs (line[kept % LOG_WIN], stdout) ;
+          after += 1 ;
+     }
+
+     if (after < 0)
+          error = 5 ;
+
+     quit :
+
+     if (name_idx != NULL)
+          free (name_idx) ;
+     if (entry != NULL)
+          free (entry) ;
+     if (file != NULL)
+          fclose (file) ;
+     if (index != NULL)
+          fclose (index) ;
+
+     return error ;
+}
+
+int save_sum (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, bool spikes)
+{
+     // head of the log, either the statistics and regions or the spikes
+
+     if (spikes)
+          return save_spk (file, dsc, spk) ;
 
      save_dsc (file, mds, dpm, dsc) ;
      save_reg (file, dsc) ;
-     save_spk (file, dsc, spk) ;
-     save_dpm (file, mds, dpm, dsc) ;
 
-     fclose (file) ;
+     return 0 ;
+}
+
+int save_win (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, unsigned long sector, unsigned int count)
+{
+     unsigned long first = sector / mds->itv ;
+
+     if (first >= mds->smp)
+          return 1 ;
+
+     unsigned long last = first + count < mds->smp ? first + count : mds->smp ;
+
+     // events before the window give the mark of its first line
+
+     unsigned char inc_num = 0 ;
+     unsigned char dec_num = 0 ;
+
+     while (inc_num < dsc->inc_cnt && dsc->inc_lba[inc_num] <= first * mds->itv)
+          inc_num += 1 ;
+     while (dec_num < dsc->dec_cnt && dsc->dec_lba[dec_num] <= first * mds->itv)
+          dec_num += 1 ;
+
+     bool rise = inc_num > 0 && (dec_num == 0 || dsc->inc_lba[inc_num-1] > dsc->dec_lba[dec_num-1]) ;
+     char mark = rise ? '>' : '|' ;
+
+     unsigned long sector_end = first * mds->itv ;
+
+     for (unsigned long i = first ; i < last ; i++)
+     {
+          sector_end += mds->itv ;
+
+          if (inc_num < dsc->inc_cnt && sector_end == dsc->inc_lba[inc_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   INCREASE # %d\n", inc_num + 1) ;
+               mark = '>' ;
+               inc_num += 1 ;
+          }
+          else if (dec_num < dsc->dec_cnt && sector_end == dsc->dec_lba[dec_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   DECREASE # %d\n", dec_num + 1) ;
+               mark = '|' ;
+               dec_num += 1 ;
+          }
+
+          fprintf (file, "[%07ld - %07ld] %08ld %d %+d \t %c\n",
+                   sector_end - mds->itv, sector_end, dpm[i].raw, dpm[i].tim, dpm[i].var, mark) ;
+     }
 
      return 0 ;
 }
@@ -23,14 +23,65 @@
 # include <stdio.h>
 # include <stdlib.h>
 # include <string.h>
+# include <stdbool.h>
+
+# if LINUX
+# include <unistd.h>
+# include <pthread.h>
+# endif
 
 # include "type.h"
+# include "arena.h"
+# include "metric.h"
+# include "svg.h"
+
+// samples kept on each side of an event in sparse logs
+//  and sample lines between two index entries
+
+# define LOG_WIN 16
+# define LOG_STEP 64
+# define LOG_MAGIC "DPMIDX01"
+
+// samples formatted by one thread when the sample lines are written in parallel
+
+# define LOG_CHK 4096
+
+typedef struct chk
+{
+     MDS *mds ;
+     DPM *dpm ;
+     DSC *dsc ;
+     unsigned int stt ;
+     unsigned int stp ;
+     unsigned char inc_num ;
+     unsigned char dec_num ;
+     char mark ;
+     char *buf ;
+     size_t len ;
+     unsigned long (*entry)[2] ;
+     unsigned int entry_cnt ;
+     bool fail ;
+}
+CHK ;
 
 static int save_dsc (FILE *file, MDS *mds, DPM *dpm, DSC *dsc) ;
+static int save_dis (FILE *file, DIS *dis) ;
 static int save_reg (FILE *file, DSC *dsc) ;
 static int save_spk (FILE *file, DSC *dsc, SPK *spk) ;
-static int save_dpm (FILE *file, MDS *mds, DPM *dpm, DSC *dsc) ;
+static unsigned int same_mtc (MDS *mds, unsigned long *rul, unsigned char rul_cnt, unsigned long *mtc, unsigned char mtc_cnt) ;
+static int list_mtc (FILE *file, MDS *mds, unsigned long *rul, unsigned char rul_cnt,
+                     unsigned long *mtc, unsigned char mtc_cnt, char *kind) ;
+static int save_mtc (FILE *file, MDS *mds, DSC *dsc) ;
+static unsigned int list_evt (MDS *mds, DSC *dsc, unsigned int *evt) ;
+static void *form_chk (void *arg) ;
+static int save_par (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, FILE *index, unsigned int jobs) ;
+static int save_dpm (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, bool sparse, FILE *index, unsigned int jobs) ;
+static char *make_ext (char *name, char *ext, ARN *arn) ;
 
-int save_log (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name) ;
+int save_txt (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, bool sparse, FILE *index, unsigned int jobs) ;
+int save_log (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name, OPT *opt, ARN *arn) ;
+int seek_log (char *path, unsigned long sector) ;
+int save_sum (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, bool spikes) ;
+int save_win (FILE *file, MDS *mds, DPM *dpm, DSC *dsc, unsigned long sector, unsigned int count) ;
 
 # endif
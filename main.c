@@ -25,84 +25,399 @@
 # endif
 
 # include "type.h"
+# include "arena.h"
+# include "stream.h"
 # include "parse.h"
 # include "draw.h"
 # include "scan.h"
 # include "log.h"
+# include "sig.h"
+# include "skim.h"
+# include "fleet.h"
+# include "metric.h"
+
+# if LINUX
+# include "triage.h"
+# include "align.h"
+# include "watch.h"
+# include "batch.h"
+# include "serve.h"
+# include "blend.h"
+# include "verify.h"
+# endif
+
+# if LINUX
+
+static int read_opt (int argc, char **argv, OPT *opt)
+{
+     int flag = 0 ;
+
+     while ((flag = getopt (argc, argv, "tcpwmbvVj:Ha:i:q:l:k:sxSGg:d:r:o:u:e:n:y:z:f:")) != -1)
+     {
+          switch (flag)
+          {
+               case 't' :
+               case 'c' :
+               case 'p' :
+               case 'm' :
+               case 'w' :
+               case 'b' :
+               case 'v' :
+               case 'V' :
+                    opt->mode = flag ;
+                    break ;
+               case 'j' :
+                    opt->job = atoi (optarg) ;
+                    break ;
+               case 'H' :
+                    opt->huge = true ;
+                    break ;
+               case 'a' :
+                    opt->win = atoi (optarg) ;
+                    break ;
+               case 'i' :
+               case 'q' :
+                    opt->mode = flag ;
+                    opt->lib = optarg ;
+                    break ;
+               case 'l' :
+                    opt->tag = optarg ;
+                    break ;
+               case 'k' :
+                    opt->top = atoi (optarg) ;
+                    break ;
+               case 's' :
+                    opt->sparse = true ;
+                    break ;
+               case 'x' :
+                    opt->index = true ;
+                    break ;
+               case 'S' :
+                    opt->svg = true ;
+                    break ;
+               case 'G' :
+                    opt->glitch = true ;
+                    break ;
+               case 'g' :
+                    opt->mode = flag ;
+                    opt->sct = strtoul (optarg, NULL, 10) ;
+                    break ;
+               case 'd' :
+                    opt->drv = optarg ;
+                    break ;
+               case 'r' :
+                    opt->res = optarg ;
+                    break ;
+               case 'o' :
+                    opt->out = optarg ;
+                    break ;
+               case 'u' :
+                    opt->dep = atoi (optarg) ;
+                    break ;
+               case 'e' :
+                    opt->met = optarg ;
+                    break ;
+               case 'n' :
+               case 'y' :
+                    opt->mode = flag ;
+                    opt->sock = optarg ;
+                    break ;
+               case 'z' :
+                    opt->mem = atoi (optarg) ;
+                    break ;
+               case 'f' :
+                    opt->tpl = optarg ;
+                    break ;
+               default :
+                    return 1 ;
+          }
+     }
+
+     return 0 ;
+}
+
+# endif
 
 int main (int argc, char **argv)
 {
      FILE *file = NULL ;
+     SRC src = {0} ;
+     ARN arn = {0} ;
      char *name = NULL ;
      DPM *dpm = NULL ;
      SPK *spk = NULL ;
 
      int error = 0 ;
 
-     if (argc < 2)
+     OPT opt = {0} ;
+     int arg = 1 ;
+
+     // outcome of a single file for the metrics
+
+     bool single = false ;
+     unsigned long smp = 0 ;
+     int cat = -1 ;
+
+     # if LINUX
+
+     if (read_opt (argc, argv, &opt) != 0)
           { error = 1 ; goto quit ; }
 
-     char *path = argv[1] ;
+     arg = optind ;
 
-     if (get_name (path, &name) != 0)
-          { error = 2 ; goto quit ; }
+     // the server takes its requests from the socket, no file arguments
+
+     if (opt.mode == 'n')
+     {
+          if (serve (opt.sock, &opt) != 0)
+               error = 19 ;
+          goto quit ;
+     }
+
+     // the self-check always runs its generated dumps, files are optional
+
+     if (opt.mode == 'V')
+     {
+          if (verify (argv + arg, argc - arg) != 0)
+               error = 21 ;
+          goto quit ;
+     }
+
+     # endif
+
+     if (argc < arg + 1)
+          { error = 1 ; goto quit ; }
+
+     if (opt.met != NULL && open_met (opt.met) != 0)
+          { error = 18 ; goto quit ; }
+
+     # if LINUX
+
+     // modes that never fork export from now on, a single file only
+     //  once its chart child is gone its own way
+
+     if (opt.mode != 0 && strchr ("tgmbvcw", opt.mode) != NULL && run_met () != 0)
+          { error = 18 ; goto quit ; }
+
+     if (opt.mode == 't')
+     {
+          if (triage (argv + arg, argc - arg, opt.job) != 0)
+               error = 8 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'g')
+     {
+          if (seek_log (argv[arg], opt.sct) != 0)
+               error = 15 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'm')
+     {
+          if (fleet (argv + arg, argc - arg, &opt) != 0)
+               error = 16 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'b')
+     {
+          if (batch (argv + arg, argc - arg, &opt) != 0)
+               error = 17 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'v')
+     {
+          if (blend (argv + arg, argc - arg, &opt) != 0)
+               error = 20 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'c')
+     {
+          if (align (argv + arg, argc - arg, &opt) != 0)
+               error = 13 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'w')
+     {
+          if (watch (argv[arg], &opt) != 0)
+               error = 12 ;
+          goto quit ;
+     }
+
+     if (opt.mode == 'y')
+     {
+          if (view (opt.sock, argv[arg], &opt) != 0)
+               error = 22 ;
+          goto quit ;
+     }
+
+     # endif
 
-     file = fopen (path, "rb") ;
-     if (file == NULL)
-          { error = 3 ; goto quit ; }
+     char *path = argv[arg] ;
 
      MDS mds = {0} ;
 
-     read_mds (file, &mds) ;
+     single = true ;
+     unsigned long tick = time_met () ;
+
+     // pipes and compressed files are read forward only
+
+     bool stream = test_src (path) ;
+
+     if (stream)
+     {
+          if (open_src (path, &src) != 0)
+               { error = 3 ; goto quit ; }
+
+          if (pull_mds (&src, &mds) != 0)
+               { error = 7 ; goto quit ; }
+     }
+     else
+     {
+          file = fopen (path, "rb") ;
+          if (file == NULL)
+               { error = 3 ; goto quit ; }
+
+          if (read_mds (file, &mds) != 0)
+               { error = 7 ; goto quit ; }
+     }
+
+     // every buffer of this file comes from one block sized from the header
+
+     if (make_arn (&arn, size_arn (&mds, &opt, path), opt.huge) != 0)
+          { error = 4 ; goto quit ; }
+
+     if (get_name (path, &name, &arn) != 0)
+          { error = 2 ; goto quit ; }
+
+     // a preview of a large file stands instead of the full analysis,
+     //  small files and pipes are analyzed whole as usual
+
+     if (opt.mode == 'p' && ! stream)
+     {
+          int pre = skim (file, &mds, name, &opt) ;
+
+          if (pre == 2)
+               { error = 4 ; goto quit ; }
+          if (pre == 3)
+               { error = 5 ; goto quit ; }
+          if (pre == 4)
+               { error = 11 ; goto quit ; }
 
-     dpm = calloc (mds.smp, sizeof (DPM)) ;
+          if (pre == 0)
+               { smp = mds.smp ; goto quit ; }
+     }
+
+     dpm = make_dpm (&arn, mds.smp) ;
      if (dpm == NULL)
           { error = 4 ; goto quit ; }
 
-     read_dpm (file, &mds, dpm) ;
+     if (stream)
+     {
+          if (pull_dpm (&src, &mds, dpm) != 0)
+               { error = 9 ; goto quit ; }
 
-     fclose (file) ;
-     file = NULL ;
+          close_src (&src) ;
+     }
+     else
+     {
+          read_dpm (file, &mds, dpm) ;
+
+          fclose (file) ;
+          file = NULL ;
+     }
+
+     smp = mds.smp ;
+
+     span_met (MET_PARSE, tick) ;
+     byte_met (MET_IN, base_dpm (&mds) + mds.smp * sizeof (unsigned int)) ;
 
      # if LINUX
 
+     // the chart child draws its own copy of the samples during the analysis
+
      int pid = fork () ;
      if (pid == 0)
      {
-          draw_dpm (&mds, dpm, name) ;
+          draw_dpm (&mds, dpm, name, &arn) ;
 
-          free (dpm) ;
-          dpm = NULL ;
+          free_arn (&arn) ;
 
           return 0 ;
      }
 
      # endif
 
+     if (run_met () != 0)
+          { error = 18 ; goto quit ; }
+
      DSC dsc = {0} ;
 
-     if (eval_dpm (&mds, dpm, &dsc, &spk) == 2)
+     tick = time_met () ;
+
+     int state = eval_dpm (&mds, dpm, &dsc, &spk, &opt, &arn) ;
+
+     span_met (MET_EVAL, tick) ;
+
+     if (state == 2)
           { error = 5 ; goto quit ; }
+     if (state == 3)
+          { error = 10 ; goto quit ; }
+
+     cat = dsc.dpm_cat ;
+     tick = time_met () ;
 
-     if (save_log (&mds, dpm, &dsc, spk, name) != 0)
+     if (save_log (&mds, dpm, &dsc, spk, name, &opt, &arn) != 0)
           { error = 6 ; goto quit ; }
 
+     span_met (MET_SAVE, tick) ;
+
+     // results line for the fleet statistics
+
+     if (opt.res != NULL && save_res (opt.res, &opt, name, &mds, &dsc, spk) != 0)
+          { error = 6 ; goto quit ; }
+
+     // signature added to a library of references or matched against it
+
+     if (opt.mode == 'i' || opt.mode == 'q')
+     {
+          SIG sig = {0} ;
+
+          snprintf (sig.tag, sizeof (sig.tag), "%s", opt.tag != NULL ? opt.tag : name) ;
+          snprintf (sig.ref, sizeof (sig.ref), "%s", name) ;
+
+          if (make_sig (&mds, dpm, &dsc, spk, &sig) != 0)
+               { error = 14 ; goto quit ; }
+
+          if (opt.mode == 'i' && add_sig (opt.lib, &sig) != 0)
+               { error = 14 ; goto quit ; }
+          if (opt.mode == 'q' && find_sig (opt.lib, &sig, opt.top) != 0)
+               { error = 14 ; goto quit ; }
+     }
+
      # if WINDOWS
 
-     draw_dpm (&mds, dpm, name) ;
+     draw_dpm (&mds, dpm, name, &arn) ;
 
      # endif
 
      quit :
 
-     if (spk != NULL)
-          free (spk) ;
-     if (dpm != NULL)
-          free (dpm) ;
-     if (name != NULL)
-          free (name) ;
+     if (single)
+          file_met (error, cat, smp) ;
+
+     shut_met () ;
+
+     free_arn (&arn) ;
+
      if (file != NULL)
           fclose (file) ;
+     if (src.file != NULL)
+          close_src (&src) ;
      if (error != 0)
           fprintf (stderr, "\e[1;31mError # %d\e[0m\n", error) ;
 
@@ -0,0 +1,277 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "match.h"
+
+// alternative detector, the variations are correlated with spike templates
+//  learned from the spikes that the rules confirmed in good dumps
+
+static int load_tpl (FILE *file, TPL *tpl)
+{
+     char magic[8] = {0} ;
+
+     // one record per interval, an empty file has none yet
+
+     rewind (file) ;
+
+     if (fread (magic, 8, 1, file) != 1)
+          return 0 ;
+     if (memcmp (magic, TPL_MAGIC, 8))
+          return 1 ;
+     if (fread (tpl, sizeof (TPL), 4, file) != 4)
+          return 1 ;
+
+     return 0 ;
+}
+
+static int save_tpl (FILE *file, TPL *tpl)
+{
+     rewind (file) ;
+
+     if (fwrite (TPL_MAGIC, 8, 1, file) != 1)
+          return 1 ;
+     if (fwrite (tpl, sizeof (TPL), 4, file) != 4)
+          return 1 ;
+
+     return fflush (file) != 0 ;
+}
+
+static int learn_tpl (MDS *mds, DPM *dpm, DSC *dsc, TPL *tpl)
+{
+     // windows aligned on the sample of each increase and decrease
+
+     for (int kind = 0 ; kind < 2 ; kind++)
+     {
+          unsigned long *lba = kind ? dsc->dec_lba : dsc->inc_lba ;
+          unsigned char cnt = kind ? dsc->dec_cnt : dsc->inc_cnt ;
+
+          for (int i = 0 ; i < cnt ; i++)
+          {
+               signed int smp = lba[i] / mds->itv - 1 ;
+
+               if (smp < 0 || smp >= mds->smp)
+                    continue ;
+
+               for (int k = 0 ; k < MTC_LEN ; k++)
+                    tpl->sum[kind][k] += dpm[smp-MTC_PRE+k].var ;
+
+               tpl->cnt[kind] += 1 ;
+          }
+     }
+
+     return 0 ;
+}
+
+static float form_tpl (TPL *tpl, int kind, float *vec)
+{
+     // average window without its mean, so that only the shape is matched
+
+     if (tpl->cnt[kind] == 0)
+          return 0 ;
+
+     float mean = 0 ;
+     float norm = 0 ;
+
+     for (int k = 0 ; k < MTC_LEN ; k++)
+     {
+          vec[k] = tpl->sum[kind][k] / tpl->cnt[kind] ;
+          mean += vec[k] / MTC_LEN ;
+     }
+
+     for (int k = 0 ; k < MTC_LEN ; k++)
+     {
+          vec[k] -= mean ;
+          norm += vec[k] * vec[k] ;
+     }
+
+     return norm ;
+}
+
+KERNEL static int corr_dpm (const float *x, int count, const float *inc, const float *dec, const float *norm, float *score)
+{
+     // sliding dot products over contiguous samples, every window on its own
+     //  so that the loop runs over several positions per vector register,
+     //  both templates sharing the energy of the window
+
+     float *inc_scr = score ;
+     float *dec_scr = score + count ;
+
+     for (int t = 0 ; t < count ; t++)
+     {
+          float inc_dot = 0 ;
+          float dec_dot = 0 ;
+          float sum = 0 ;
+          float sqr = 0 ;
+
+          for (int k = 0 ; k < MTC_LEN ; k++)
+          {
+               float v = x[t+k] ;
+
+               inc_dot += v * inc[k] ;
+               dec_dot += v * dec[k] ;
+               sum += v ;
+               sqr += v * v ;
+          }
+
+          float var = sqr - sum * sum / MTC_LEN ;
+          if (var <= 0)
+               var = INFINITY ;
+
+          float inc_gain = inc_dot / norm[0] ;
+          float dec_gain = dec_dot / norm[1] ;
+
+          // squared normalized correlation keeping its sign, no square root
+          //  in the loop, kept only when the amplitude is close to the template
+
+          inc_scr[t] = (inc_gain >= MTC_LOW) & (inc_gain <= MTC_HIGH) ? inc_dot * fabsf (inc_dot) / (var * norm[0]) : 0 ;
+          dec_scr[t] = (dec_gain >= MTC_LOW) & (dec_gain <= MTC_HIGH) ? dec_dot * fabsf (dec_dot) / (var * norm[1]) : 0 ;
+     }
+
+     return 0 ;
+}
+
+static int peak_dpm (MDS *mds, float *score, unsigned long *lba, unsigned char *cnt)
+{
+     // local maxima above the threshold, a spike hiding its next samples
+
+     int next = 0 ;
+
+     for (int t = 0 ; t < mds->smp ; t++)
+     {
+          if (score[t] < MTC_MIN * MTC_MIN || t < next)
+               continue ;
+
+          bool peak = true ;
+
+          for (int d = 1 ; d <= MTC_PRE && peak ; d++)
+          {
+               if (t >= d && score[t-d] > score[t])
+                    peak = false ;
+               if (t + d < mds->smp && score[t+d] > score[t])
+                    peak = false ;
+          }
+
+          if (! peak)
+               continue ;
+
+          if (*cnt == 200)
+               return 1 ;
+
+          lba[*cnt] = (unsigned long) (t + 1) * mds->itv ;
+          *cnt += 1 ;
+
+          next = t + MTC_PRE + 1 ;
+     }
+
+     return 0 ;
+}
+
+size_t size_mtc (MDS *mds)
+{
+     // variations as floats with the guard samples, two scores per sample
+
+     return (mds->smp + MTC_LEN) * sizeof (float) + 2 * mds->smp * sizeof (float) + 2 * ARN_ALIGN ;
+}
+
+int mtch_dpm (MDS *mds, DPM *dpm, DSC *dsc, char *path, ARN *arn)
+{
+     TPL all[4] = {0} ;
+     TPL cur = {0} ;
+
+     unsigned int itv[4] = {50, 256, 500, 2048} ;
+
+     if (mds->smp == 0)
+          return 1 ;
+
+     FILE *file = fopen (path, "r+b") ;
+     if (file == NULL)
+          file = fopen (path, "w+b") ;
+     if (file == NULL)
+          return 1 ;
+
+     // several workers may learn at once
+
+     # if LINUX
+     flock (fileno (file), LOCK_EX) ;
+     # endif
+
+     int error = load_tpl (file, all) ;
+
+     TPL *tpl = NULL ;
+
+     for (int i = 0 ; i < 4 ; i++)
+     {
+          all[i].itv = itv[i] ;
+          if (itv[i] == mds->itv)
+               tpl = &all[i] ;
+     }
+
+     // templates as they were before this dump, then learned from it when good
+
+     if (error == 0 && tpl != NULL)
+     {
+          cur = *tpl ;
+
+          if (dsc->dpm_cat == 0)
+          {
+               learn_tpl (mds, dpm, dsc, tpl) ;
+               error = save_tpl (file, all) ;
+          }
+     }
+
+     # if LINUX
+     flock (fileno (file), LOCK_UN) ;
+     # endif
+
+     fclose (file) ;
+
+     if (error != 0 || tpl == NULL)
+          return 1 ;
+
+     dsc->mtc_run = 1 ;
+     dsc->tpl_cnt[0] = cur.cnt[0] ;
+     dsc->tpl_cnt[1] = cur.cnt[1] ;
+
+     float vec[2][MTC_LEN] ;
+     float norm[2] = { form_tpl (&cur, 0, vec[0]), form_tpl (&cur, 1, vec[1]) } ;
+
+     if (norm[0] == 0 || norm[1] == 0)
+          return 0 ;
+
+     float *x = take_arn (arn, (mds->smp + MTC_LEN) * sizeof (float)) ;
+     float *score = take_arn (arn, 2 * mds->smp * sizeof (float)) ;
+
+     if (x == NULL || score == NULL)
+          return 2 ;
+
+     unsigned long tick = time_met () ;
+
+     for (int i = - MTC_PRE ; i < (signed int) mds->smp + MTC_LEN - MTC_PRE ; i++)
+          x[i+MTC_PRE] = dpm[i].var ;
+
+     corr_dpm (x, mds->smp, vec[0], vec[1], norm, score) ;
+
+     peak_dpm (mds, score, dsc->mtc_inc, &dsc->mtc_inc_cnt) ;
+     peak_dpm (mds, score + mds->smp, dsc->mtc_dec, &dsc->mtc_dec_cnt) ;
+
+     dsc->mtc_tim = time_met () - tick ;
+     dsc->mtc_run = 2 ;
+
+     return 0 ;
+}
@@ -0,0 +1,70 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef MATCH_H
+# define MATCH_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# if LINUX
+# include <sys/file.h>
+# endif
+
+# include "type.h"
+# include "arena.h"
+# include "metric.h"
+
+// template window around a spike sample, within the guard samples
+
+# define MTC_PRE 2
+# define MTC_LEN 6
+
+// lowest normalized correlation of a spike, and the allowed gain
+//  of the samples against the template
+
+# define MTC_MIN 0.8f
+# define MTC_LOW 0.5f
+# define MTC_HIGH 2.0f
+
+# define TPL_MAGIC "DPMTPL01"
+
+// increase and decrease windows summed over the confirmed spikes of good dumps
+
+typedef struct tpl
+{
+     unsigned int itv ;
+     unsigned int cnt[2] ;
+     double sum[2][MTC_LEN] ;
+}
+TPL ;
+
+static int load_tpl (FILE *file, TPL *tpl) ;
+static int save_tpl (FILE *file, TPL *tpl) ;
+static int learn_tpl (MDS *mds, DPM *dpm, DSC *dsc, TPL *tpl) ;
+static float form_tpl (TPL *tpl, int kind, float *vec) ;
+KERNEL static int corr_dpm (const float *x, int count, const float *inc, const float *dec, const float *norm, float *score) ;
+static int peak_dpm (MDS *mds, float *score, unsigned long *lba, unsigned char *cnt) ;
+
+size_t size_mtc (MDS *mds) ;
+int mtch_dpm (MDS *mds, DPM *dpm, DSC *dsc, char *path, ARN *arn) ;
+
+# endif
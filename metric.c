@@ -0,0 +1,329 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "metric.h"
+
+static MET met_all[MET_MAX] ;
+static unsigned int met_cnt = 0 ;
+static unsigned int met_free[MET_MAX] ;
+static unsigned int met_top = 0 ;
+static __thread MET *met_own = NULL ;
+static __thread bool met_shr = false ;
+static pthread_key_t met_key ;
+static pthread_once_t met_once = PTHREAD_ONCE_INIT ;
+static pthread_mutex_t met_slot = PTHREAD_MUTEX_INITIALIZER ;
+
+static char *met_path = NULL ;
+static bool met_stop = false ;
+static bool met_run = false ;
+static pthread_t met_loop ;
+static pthread_mutex_t met_lock = PTHREAD_MUTEX_INITIALIZER ;
+static pthread_cond_t met_wake = PTHREAD_COND_INITIALIZER ;
+
+static void drop_met (void *arg)
+{
+     // an exiting thread hands its slot back, the counters stay and
+     //  the next thread carries on from them
+
+     pthread_mutex_lock (&met_slot) ;
+     met_free[met_top++] = (MET *) arg - met_all ;
+     pthread_mutex_unlock (&met_slot) ;
+}
+
+static void make_key (void)
+{
+     pthread_key_create (&met_key, drop_met) ;
+}
+
+static MET *own_met (void)
+{
+     // first count of a thread takes a released slot or the next one,
+     //  threads beyond the table share the last slot
+
+     if (met_own == NULL)
+     {
+          pthread_once (&met_once, make_key) ;
+          pthread_mutex_lock (&met_slot) ;
+
+          if (met_top > 0)
+               met_own = &met_all[met_free[--met_top]] ;
+          else if (met_cnt < MET_MAX - 1)
+          {
+               met_own = &met_all[met_cnt] ;
+               __atomic_store_n (&met_cnt, met_cnt + 1, __ATOMIC_RELAXED) ;
+          }
+          else
+          {
+               met_own = &met_all[MET_MAX - 1] ;
+               met_shr = true ;
+               __atomic_store_n (&met_cnt, MET_MAX, __ATOMIC_RELAXED) ;
+          }
+
+          pthread_mutex_unlock (&met_slot) ;
+
+          if (! met_shr)
+               pthread_setspecific (met_key, met_own) ;
+     }
+
+     return met_own ;
+}
+
+static void add_cnt (unsigned long *cnt, unsigned long val)
+{
+     // one writer per counter, a plain load and store without lock,
+     //  an atomic add on the shared last slot
+
+     if (met_shr)
+          __atomic_fetch_add (cnt, val, __ATOMIC_RELAXED) ;
+     else __atomic_store_n (cnt, *cnt + val, __ATOMIC_RELAXED) ;
+}
+
+unsigned long time_met (void)
+{
+     struct timespec now = {0} ;
+
+     clock_gettime (CLOCK_MONOTONIC, &now) ;
+
+     return now.tv_sec * 1000000000UL + now.tv_nsec ;
+}
+
+void span_met (int stg, unsigned long stt)
+{
+     MET *met = own_met () ;
+
+     unsigned long len = time_met () - stt ;
+     unsigned long num = (len + 99999) / 100000 ;
+     unsigned int bkt = num <= 1 ? 0 : 64 - __builtin_clzl (num - 1) ;
+
+     if (bkt > MET_BKT)
+          bkt = MET_BKT ;
+
+     add_cnt (&met->lat[stg][bkt], 1) ;
+     add_cnt (&met->sum[stg], len) ;
+}
+
+void file_met (int error, int cat, unsigned long smp)
+{
+     MET *met = own_met () ;
+
+     if (error != 0)
+          add_cnt (&met->fail[error < MET_ERR ? error : 0], 1) ;
+     else add_cnt (&met->done, 1) ;
+
+     if (cat >= 0 && cat < MET_CAT)
+          add_cnt (&met->cat[cat], 1) ;
+
+     add_cnt (&met->smp, smp) ;
+}
+
+void byte_met (int way, unsigned long len)
+{
+     add_cnt (&own_met ()->byte[way], len) ;
+}
+
+static void sum_met (MET *all)
+{
+     unsigned int cnt = __atomic_load_n (&met_cnt, __ATOMIC_RELAXED) ;
+
+     if (cnt > MET_MAX)
+          cnt = MET_MAX ;
+
+     // every counter is an unsigned long, merged slot by slot
+
+     unsigned long *dst = (unsigned long *) all ;
+     unsigned int len = offsetof (MET, sum[MET_STG]) / sizeof (unsigned long) ;
+
+     memset (all, 0, sizeof (MET)) ;
+
+     for (int i = 0 ; i < cnt ; i++)
+     {
+          unsigned long *src = (unsigned long *) &met_all[i] ;
+
+          for (int j = 0 ; j < len ; j++)
+               dst[j] += __atomic_load_n (&src[j], __ATOMIC_RELAXED) ;
+     }
+}
+
+static int save_met (char *path, double rate)
+{
+     static const char *cat_name[MET_CAT] = { "spikes", "normal", "unreliable" } ;
+     static const char *stg_name[MET_STG] = { "parse", "eval", "save" } ;
+
+     MET all = {0} ;
+
+     sum_met (&all) ;
+
+     // written aside then renamed, the collector never reads half a file
+
+     char tmp[4096] ;
+     snprintf (tmp, sizeof (tmp), "%s.tmp", path) ;
+
+     FILE *file = fopen (tmp, "w") ;
+     if (file == NULL)
+          return 1 ;
+
+     fprintf (file, "# HELP dpmscn_files_total Files analyzed without error.\n") ;
+     fprintf (file, "# TYPE dpmscn_files_total counter\n") ;
+     fprintf (file, "dpmscn_files_total %lu\n", all.done) ;
+
+     fprintf (file, "# HELP dpmscn_files_failed_total Files failed, by error code.\n") ;
+     fprintf (file, "# TYPE dpmscn_files_failed_total counter\n") ;
+
+     for (int i = 1 ; i < MET_ERR ; i++)
+     {
+          if (all.fail[i] != 0)
+               fprintf (file, "dpmscn_files_failed_total{code=\"%d\"} %lu\n", i, all.fail[i]) ;
+     }
+
+     fprintf (file, "# HELP dpmscn_layout_total Files analyzed, by layout.\n") ;
+     fprintf (file, "# TYPE dpmscn_layout_total counter\n") ;
+
+     for (int i = 0 ; i < MET_CAT ; i++)
+          fprintf (file, "dpmscn_layout_total{layout=\"%s\"} %lu\n", cat_name[i], all.cat[i]) ;
+
+     fprintf (file, "# HELP dpmscn_samples_total DPM samples analyzed.\n") ;
+     fprintf (file, "# TYPE dpmscn_samples_total counter\n") ;
+     fprintf (file, "dpmscn_samples_total %lu\n", all.smp) ;
+
+     fprintf (file, "# HELP dpmscn_samples_per_second DPM samples analyzed per second since the last export.\n") ;
+     fprintf (file, "# TYPE dpmscn_samples_per_second gauge\n") ;
+     fprintf (file, "dpmscn_samples_per_second %.0f\n", rate) ;
+
+     fprintf (file, "# HELP dpmscn_read_bytes_total Bytes of MDS files read.\n") ;
+     fprintf (file, "# TYPE dpmscn_read_bytes_total counter\n") ;
+     fprintf (file, "dpmscn_read_bytes_total %lu\n", all.byte[MET_IN]) ;
+
+     fprintf (file, "# HELP dpmscn_written_bytes_total Bytes of logs and indexes written.\n") ;
+     fprintf (file, "# TYPE dpmscn_written_bytes_total counter\n") ;
+     fprintf (file, "dpmscn_written_bytes_total %lu\n", all.byte[MET_OUT]) ;
+
+     fprintf (file, "# HELP dpmscn_stage_seconds Time spent per file in each stage.\n") ;
+     fprintf (file, "# TYPE dpmscn_stage_seconds histogram\n") ;
+
+     for (int i = 0 ; i < MET_STG ; i++)
+     {
+          unsigned long cnt = 0 ;
+
+          for (int j = 0 ; j < MET_BKT ; j++)
+          {
+               cnt += all.lat[i][j] ;
+               fprintf (file, "dpmscn_stage_seconds_bucket{stage=\"%s\",le=\"%g\"} %lu\n", stg_name[i], 0.0001 * (1UL << j), cnt) ;
+          }
+
+          cnt += all.lat[i][MET_BKT] ;
+
+          fprintf (file, "dpmscn_stage_seconds_bucket{stage=\"%s\",le=\"+Inf\"} %lu\n", stg_name[i], cnt) ;
+          fprintf (file, "dpmscn_stage_seconds_sum{stage=\"%s\"} %.6f\n", stg_name[i], all.sum[i] / 1e9) ;
+          fprintf (file, "dpmscn_stage_seconds_count{stage=\"%s\"} %lu\n", stg_name[i], cnt) ;
+     }
+
+     bool fail = ferror (file) ;
+
+     if (fclose (file) != 0 || fail || rename (tmp, path) != 0)
+          { remove (tmp) ; return 2 ; }
+
+     return 0 ;
+}
+
+static void *loop_met (void *arg)
+{
+     unsigned long last = time_met () ;
+     unsigned long smp = 0 ;
+
+     pthread_mutex_lock (&met_lock) ;
+
+     while (true)
+     {
+          struct timespec time = {0} ;
+
+          clock_gettime (CLOCK_REALTIME, &time) ;
+          time.tv_sec += MET_SEC ;
+
+          while (! met_stop && pthread_cond_timedwait (&met_wake, &met_lock, &time) == 0) ;
+
+          // rate over the time since the previous export
+
+          MET all = {0} ;
+          sum_met (&all) ;
+
+          unsigned long now = time_met () ;
+          double rate = (all.smp - smp) * 1e9 / (now - last + 1) ;
+
+          smp = all.smp ;
+          last = now ;
+
+          save_met (met_path, rate) ;
+
+          if (met_stop)
+               break ;
+     }
+
+     pthread_mutex_unlock (&met_lock) ;
+
+     return NULL ;
+}
+
+int open_met (char *path)
+{
+     // only the path here, the exporter thread is started by run_met
+     //  once the process will not fork any more, a child would inherit
+     //  its lock in whatever state the thread left it
+
+     met_path = path ;
+     met_stop = false ;
+
+     return 0 ;
+}
+
+int run_met (void)
+{
+     if (met_path == NULL || met_run)
+          return 0 ;
+
+     if (pthread_create (&met_loop, NULL, loop_met, NULL) != 0)
+          return 1 ;
+
+     met_run = true ;
+
+     return 0 ;
+}
+
+void shut_met (void)
+{
+     // one last export with the final counts, written here when the
+     //  thread was never started
+
+     if (met_path == NULL)
+          return ;
+
+     if (met_run)
+     {
+          pthread_mutex_lock (&met_lock) ;
+          met_stop = true ;
+          pthread_cond_signal (&met_wake) ;
+          pthread_mutex_unlock (&met_lock) ;
+
+          pthread_join (met_loop, NULL) ;
+
+          met_run = false ;
+     }
+     else save_met (met_path, 0) ;
+
+     met_path = NULL ;
+}
@@ -0,0 +1,75 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef METRIC_H
+# define METRIC_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <stddef.h>
+# include <time.h>
+# include <pthread.h>
+
+// one past the largest error code of main (22, view), layouts of
+//  eval_reg, latency buckets doubling from 100 microseconds, threads
+//  with their own counters
+
+# define MET_ERR 23
+# define MET_CAT 3
+# define MET_BKT 16
+# define MET_MAX 256
+# define MET_SEC 10
+
+enum { MET_PARSE, MET_EVAL, MET_SAVE, MET_STG } ;
+enum { MET_IN, MET_OUT } ;
+
+// counters written by a single thread and read by the exporter,
+//  a cache line of their own so threads never share one
+
+typedef struct met
+{
+     unsigned long done ;
+     unsigned long fail[MET_ERR] ;
+     unsigned long cat[MET_CAT] ;
+     unsigned long smp ;
+     unsigned long byte[2] ;
+     unsigned long lat[MET_STG][MET_BKT + 1] ;
+     unsigned long sum[MET_STG] ;
+}
+__attribute__ ((aligned (64))) MET ;
+
+static void drop_met (void *arg) ;
+static void make_key (void) ;
+static MET *own_met (void) ;
+static void add_cnt (unsigned long *cnt, unsigned long val) ;
+static void sum_met (MET *all) ;
+static int save_met (char *path, double rate) ;
+static void *loop_met (void *arg) ;
+
+unsigned long time_met (void) ;
+void span_met (int stg, unsigned long stt) ;
+void file_met (int error, int cat, unsigned long smp) ;
+void byte_met (int way, unsigned long len) ;
+int open_met (char *path) ;
+int run_met (void) ;
+void shut_met (void) ;
+
+# endif
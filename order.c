@@ -0,0 +1,208 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "order.h"
+
+// order statistic window over the latest samples
+// a binary indexed tree counts the values of the window by bin,
+//  the median is found by descending it and the median absolute deviation
+//  by counting the values around the current median, in logarithmic time
+
+static unsigned int find_bin (OSW *osw, signed int value)
+{
+     // bins are centered on the first value of the window, variations
+     //  farther than half the bins are far beyond any timing range
+
+     signed int bin = value - osw->base + OSW_BIN / 2 ;
+
+     if (bin < 0)
+          bin = 0 ;
+     if (bin >= OSW_BIN)
+          bin = OSW_BIN - 1 ;
+
+     return bin ;
+}
+
+static void add_bin (unsigned int *bit, unsigned int bin, signed int step)
+{
+     for (unsigned int i = bin + 1 ; i <= OSW_BIN ; i += i & -i)
+          bit[i] += step ;
+}
+
+static unsigned int sum_bin (unsigned int *bit, signed int bin)
+{
+     // values in the bins up to the given one, none below the first
+
+     unsigned int sum = 0 ;
+
+     if (bin >= OSW_BIN)
+          bin = OSW_BIN - 1 ;
+
+     for (signed int i = bin + 1 ; i > 0 ; i -= i & -i)
+          sum += bit[i] ;
+
+     return sum ;
+}
+
+static unsigned int rank_bin (unsigned int *bit, unsigned int rank)
+{
+     // bin of the value with the given rank, 0 being the smallest
+
+     unsigned int pos = 0 ;
+
+     for (unsigned int step = OSW_BIN ; step > 0 ; step >>= 1)
+     {
+          if (pos + step <= OSW_BIN && bit[pos+step] <= rank)
+          {
+               pos += step ;
+               rank -= bit[pos] ;
+          }
+     }
+
+     return pos ;
+}
+
+static unsigned int span_bin (unsigned int *bit, unsigned int bin, unsigned int dev)
+{
+     // values at most the given deviation away from a bin
+
+     return sum_bin (bit, bin + dev) - sum_bin (bit, (signed int) bin - (signed int) dev - 1) ;
+}
+
+static unsigned int seek_mad (OSW *osw, unsigned int bin, unsigned int rank)
+{
+     // smallest deviation from the median holding more values than the rank,
+     //  searched from the previous one as it rarely moves far
+
+     unsigned int dev = osw->mad ;
+
+     if (span_bin (osw->bit, bin, dev) > rank)
+     {
+          if (dev == 0 || span_bin (osw->bit, bin, dev - 1) <= rank)
+               return dev ;
+
+          // galloping down from a deviation known to hold enough values,
+          //  then halving between the last two steps
+
+          unsigned int step = 1 ;
+          while (step * 2 <= dev && span_bin (osw->bit, bin, dev - step * 2) > rank)
+               step *= 2 ;
+
+          unsigned int low = step * 2 <= dev ? dev - step * 2 + 1 : 0 ;
+          unsigned int high = dev - step ;
+
+          while (low < high)
+          {
+               unsigned int mid = low + (high - low) / 2 ;
+
+               if (span_bin (osw->bit, bin, mid) > rank)
+                    high = mid ;
+               else low = mid + 1 ;
+          }
+
+          return low ;
+     }
+
+     // galloping up, the largest deviation holding every value
+
+     unsigned int step = 1 ;
+     while (dev + step < OSW_BIN - 1 && span_bin (osw->bit, bin, dev + step) <= rank)
+          step *= 2 ;
+
+     unsigned int low = dev + step / 2 + 1 ;
+     unsigned int high = dev + step < OSW_BIN - 1 ? dev + step : OSW_BIN - 1 ;
+
+     while (low < high)
+     {
+          unsigned int mid = low + (high - low) / 2 ;
+
+          if (span_bin (osw->bit, bin, mid) > rank)
+               high = mid ;
+          else low = mid + 1 ;
+     }
+
+     return low ;
+}
+
+size_t size_osw (unsigned int size)
+{
+     size_t tree = (OSW_BIN + 1) * sizeof (unsigned int) + ARN_ALIGN ;
+     size_t ring = size * sizeof (signed int) + ARN_ALIGN ;
+
+     return tree + ring ;
+}
+
+int make_osw (OSW *osw, unsigned int size, ARN *arn)
+{
+     osw->bit = take_arn (arn, (OSW_BIN + 1) * sizeof (unsigned int)) ;
+     osw->ring = take_arn (arn, size * sizeof (signed int)) ;
+
+     if (osw->bit == NULL || osw->ring == NULL)
+          return 1 ;
+
+     osw->size = size ;
+
+     rset_osw (osw) ;
+
+     return 0 ;
+}
+
+void rset_osw (OSW *osw)
+{
+     memset (osw->bit, 0, (OSW_BIN + 1) * sizeof (unsigned int)) ;
+
+     osw->cnt = 0 ;
+     osw->head = 0 ;
+     osw->base = 0 ;
+     osw->med = 0 ;
+     osw->mad = 0 ;
+}
+
+void push_osw (OSW *osw, signed int value)
+{
+     if (osw->cnt == 0 && osw->head == 0)
+          osw->base = value ;
+
+     signed int *slot = osw->ring + osw->head ;
+
+     // the oldest sample leaves a full window
+
+     if (osw->cnt == osw->size)
+     {
+          add_bin (osw->bit, find_bin (osw, *slot), -1) ;
+          osw->cnt -= 1 ;
+     }
+
+     *slot = value ;
+
+     add_bin (osw->bit, find_bin (osw, value), 1) ;
+     osw->cnt += 1 ;
+
+     osw->head += 1 ;
+     if (osw->head == osw->size)
+          osw->head = 0 ;
+
+     // deviations are measured against the median of the window as it is now
+
+     unsigned int rank = (osw->cnt - 1) / 2 ;
+     unsigned int bin = rank_bin (osw->bit, rank) ;
+
+     osw->med = osw->base + (signed int) bin - OSW_BIN / 2 ;
+     osw->mad = seek_mad (osw, bin, rank) ;
+}
@@ -0,0 +1,59 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef ORDER_H
+# define ORDER_H
+
+# include <stdlib.h>
+# include <string.h>
+
+# include "type.h"
+# include "arena.h"
+
+// number of distinct values around the first one of a window,
+//  a power of two, farther ones are clamped to the ends
+
+# define OSW_BIN 65536
+
+typedef struct osw
+{
+     unsigned int *bit ;
+     signed int *ring ;
+     unsigned int size ;
+     unsigned int cnt ;
+     unsigned int head ;
+     signed int base ;
+     signed int med ;
+     signed int mad ;
+}
+OSW ;
+
+static unsigned int find_bin (OSW *osw, signed int value) ;
+static void add_bin (unsigned int *bit, unsigned int bin, signed int step) ;
+static unsigned int sum_bin (unsigned int *bit, signed int bin) ;
+static unsigned int rank_bin (unsigned int *bit, unsigned int rank) ;
+static unsigned int span_bin (unsigned int *bit, unsigned int bin, unsigned int dev) ;
+static unsigned int seek_mad (OSW *osw, unsigned int bin, unsigned int rank) ;
+
+size_t size_osw (unsigned int size) ;
+int make_osw (OSW *osw, unsigned int size, ARN *arn) ;
+void rset_osw (OSW *osw) ;
+void push_osw (OSW *osw, signed int value) ;
+
+# endif
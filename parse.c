@@ -19,16 +19,25 @@
 
 # include "parse.h"
 
-int get_name (char *path, char **name)
+int get_name (char *path, char **name, ARN *arn)
 {
+     if (strcmp (path, "-") == 0)
+          path = "stdin.mds" ;
+
      unsigned int len = strlen (path) ;
-     char *ext = path + (len - 4) ;
 
-     if (strcmp (ext, ".mds") != 0)
+     // compressed files are named after the MDS file they contain
+
+     if (len > 3 && strcmp (path + len - 3, ".gz") == 0)
+          len -= 3 ;
+     else if (len > 4 && strcmp (path + len - 4, ".zst") == 0)
+          len -= 4 ;
+
+     if (len < 4 || strncmp (path + len - 4, ".mds", 4) != 0)
           return 1 ;
 
-     *name = calloc (len + 1, sizeof (char)) ;
-     if (name == NULL)
+     *name = take_arn (arn, len + 1) ;
+     if (*name == NULL)
           return 2 ;
 
      strncpy (*name, path, len - 4) ;
@@ -36,34 +45,39 @@ int get_name (char *path, char **name)
      return 0 ;
 }
 
-int read_mds (FILE *file, MDS *mds)
+static char *text[] =
 {
-     char file_id[16] ;
-
-     fseek (file, 0x00, SEEK_SET) ;
-     fread (file_id, 16, 1, file) ;
+     "",
+     "No MDS",
+     "Unsupported file version",
+     "Unknown disc format",
+     "No DPM",
+     "Unknown header structure",
+     "Unknown interval value",
+} ;
+
+static unsigned long get_le (unsigned char *byte, int len)
+{
+     unsigned long value = 0 ;
 
-     if (memcmp ("MEDIA DESCRIPTOR", file_id, 16))
-     {
-          fprintf (stderr, "No MDS\n") ;
-          exit (EXIT_FAILURE) ;
-     }
+     for (int i = len - 1 ; i >= 0 ; i--)
+          value = (value << 8) | byte[i] ;
 
-     unsigned char byte = 0 ;
+     return value ;
+}
 
-     fseek (file, 0x11, SEEK_SET) ;
-     fread (&byte, 1, 1, file) ;
+static int load_mds (unsigned char *head, unsigned char *tail, MDS *mds)
+{
+     // head holds the file bytes [0x00 - MDS_HEAD]
+     // tail holds the file bytes [ptr - MDS_BACK, ptr + MDS_NEXT]
 
-     if (byte != 0x05)
-     {
-          fprintf (stderr, "Unsupported file version\n") ;
-          exit (EXIT_FAILURE) ;
-     }
+     if (memcmp ("MEDIA DESCRIPTOR", head, 16))
+          return 1 ;
 
-     fseek (file, 0x12, SEEK_SET) ;
-     fread (&byte, 1, 1, file) ;
+     if (head[0x11] != 0x05)
+          return 2 ;
 
-     switch (byte)
+     switch (head[0x12])
      {
           case 0x00 :
                mds->cd = true ;
@@ -72,18 +86,15 @@ int read_mds (FILE *file, MDS *mds)
                mds->dvd = true ;
                break ;
           default :
-               fprintf (stderr, "Unknown disc format\n") ;
-               exit (EXIT_FAILURE) ;
+               return 3 ;
      }
 
-     fseek (file, 0x54, SEEK_SET) ;
-     fread (&mds->ptr, 2, 1, file) ;
+     mds->ptr = get_le (head + 0x54, 2) ;
 
      switch (mds->ptr)
      {
           case 0x0000 :
-               fprintf (stderr, "No DPM\n") ;
-               exit (EXIT_FAILURE) ;
+               return 4 ;
           case 0x10E8 :
                mds->lay = 1 ;
                break ;
@@ -92,14 +103,12 @@ int read_mds (FILE *file, MDS *mds)
                break ;
      }
 
+     if (mds->ptr < MDS_HEAD)
+          return 5 ;
+
      if (mds->cd)
      {
-          fseek (file, 0x168, SEEK_SET) ;
-          fread (&byte, 1, 1, file) ;
-
-          byte &= 0x0F ;
-
-          switch (byte)
+          switch (head[0x168] & 0x0F)
           {
                case 0x09 :
                     sprintf (mds->mod, "audio") ;
@@ -123,56 +132,133 @@ int read_mds (FILE *file, MDS *mds)
      else if (mds->dvd && mds->lay == 2)
           sprintf (mds->mod, "double layer") ;
 
+     unsigned char *dpm_hdr = tail + MDS_BACK ;
      unsigned int offset = 0 ;
 
-     fseek (file, mds->ptr, SEEK_SET) ;
-     fread (&mds->loc, 1, 1, file) ;
+     mds->loc = dpm_hdr[0] ;
 
      switch (mds->loc)
      {
           case 0x01 :
-               offset = mds->ptr + 16 ;
+               offset = 16 ;
                break ;
           case 0x02 :
-               offset = mds->ptr + 20 ;
+               offset = 20 ;
                break ;
           default :
-               fprintf (stderr, "Unknown header structure\n") ;
-               exit (EXIT_FAILURE) ;
+               return 5 ;
      }
 
-     fseek (file, offset, SEEK_SET) ;
-     fread (&mds->itv, 2, 1, file) ;
-
-     offset += 4 ;
-
-     fseek (file, offset, SEEK_SET) ;
-     fread (&mds->smp, 2, 1, file) ;
+     mds->itv = get_le (dpm_hdr + offset, 2) ;
+     mds->smp = get_le (dpm_hdr + offset + 4, 2) ;
 
      switch (mds->itv)
      {
           case 50 :
           case 500 :
-               offset = 100 ;
+               mds->sct = get_le (head + 100, 3) ;
                break ;
           case 256 :
           case 2048 :
-               offset = mds->ptr - 128 ;
+               mds->sct = get_le (tail, 3) ;
                break ;
           default :
-               fprintf (stderr, "Unknown interval value\n") ;
-               exit (EXIT_FAILURE) ;
+               return 6 ;
      }
 
-     fseek (file, offset, SEEK_SET) ;
-     fread (&mds->sct, 3, 1, file) ;
+     return 0 ;
+}
+
+char *text_mds (int error)
+{
+     if (error < 0 || error > 6)
+          return "Unknown error" ;
+
+     return text[error] ;
+}
+
+int read_mds (FILE *file, MDS *mds)
+{
+     unsigned char head[MDS_HEAD] = {0} ;
+     unsigned char tail[MDS_BACK + MDS_NEXT] = {0} ;
+
+     fseek (file, 0x00, SEEK_SET) ;
+     fread (head, MDS_HEAD, 1, file) ;
+
+     unsigned int ptr = get_le (head + 0x54, 2) ;
+
+     if (ptr >= MDS_HEAD)
+     {
+          fseek (file, ptr - MDS_BACK, SEEK_SET) ;
+          fread (tail, MDS_BACK + MDS_NEXT, 1, file) ;
+     }
+
+     int error = load_mds (head, tail, mds) ;
+     if (error != 0)
+          fprintf (stderr, "%s\n", text_mds (error)) ;
+
+     return error ;
+}
+
+# if LINUX
+
+int peek_mds (int fd, MDS *mds)
+{
+     // same as read_mds using two positioned reads and no stream buffer
+
+     unsigned char head[MDS_HEAD] = {0} ;
+     unsigned char tail[MDS_BACK + MDS_NEXT] = {0} ;
+
+     if (pread (fd, head, MDS_HEAD, 0) < 0)
+          return 1 ;
+
+     unsigned int ptr = get_le (head + 0x54, 2) ;
+
+     if (ptr >= MDS_HEAD)
+     {
+          if (pread (fd, tail, MDS_BACK + MDS_NEXT, ptr - MDS_BACK) < 0)
+               return 5 ;
+     }
+
+     return load_mds (head, tail, mds) ;
+}
+
+# endif
+
+DPM *make_dpm (ARN *arn, unsigned int smp)
+{
+     // guard samples let the detectors read past both ends of the file
+     //  and keep the first sample aligned on the arena boundary
+
+     DPM *dpm = take_arn (arn, (smp + 2 * DPM_PAD) * sizeof (DPM)) ;
+     if (dpm == NULL)
+          return NULL ;
+
+     return dpm + DPM_PAD ;
+}
+
+KERNEL static int diff_dpm (DPM *dpm, unsigned int *raw, int smp_stt, int count)
+{
+     // raw[0] and raw[1] hold the two samples preceding the block
+
+     for (int k = 0 ; k < count ; k++)
+     {
+          unsigned int tim = raw[k+2] - raw[k+1] ;
+          unsigned int pre = raw[k+1] - raw[k] ;
+
+          dpm[smp_stt+k].raw = raw[k+2] ;
+          dpm[smp_stt+k].tim = tim ;
+          dpm[smp_stt+k].var = tim - pre ;
+     }
 
      return 0 ;
 }
 
 int read_dpm (FILE *file, MDS *mds, DPM *dpm)
 {
+     unsigned int raw[4096 + 2] = {0} ;
      unsigned int offset = 0 ;
+     unsigned int cnt = 0 ;
 
      if (mds->loc == 0x01)
           offset = mds->ptr + 24 ;
@@ -180,18 +266,155 @@ int read_dpm (FILE *file, MDS *mds, DPM *dpm)
           offset = mds->ptr + 28 ;
 
      fseek (file, offset, SEEK_SET) ;
-     fread (&dpm[0].raw, 4, 1, file) ;
 
-     dpm[0].tim = dpm[0].raw ;
+     for (int i = 0 ; i < mds->smp ; i += cnt)
+     {
+          cnt = mds->smp - i ;
+          if (cnt > 4096)
+               cnt = 4096 ;
+
+          size_t got = fread (raw + 2, 4, cnt, file) ;
+          memset (raw + 2 + got, 0, (cnt - got) * 4) ;
+
+          diff_dpm (dpm, raw, i, cnt) ;
+
+          raw[0] = raw[cnt] ;
+          raw[1] = raw[cnt+1] ;
+     }
+
+     dpm[0].var = 0 ;
+
+     return 0 ;
+}
+
+int view_mds (unsigned char *head, unsigned char *tail, MDS *mds)
+{
+     // header bytes read by the caller, see load_mds for their ranges
+
+     return load_mds (head, tail, mds) ;
+}
+
+unsigned int tail_mds (unsigned char *head)
+{
+     // file offset of the second header region, zero without one
+
+     unsigned int ptr = get_le (head + 0x54, 2) ;
+
+     return ptr >= MDS_HEAD ? ptr - MDS_BACK : 0 ;
+}
+
+unsigned int base_dpm (MDS *mds)
+{
+     // file offset of the first sample
+
+     return mds->ptr + (mds->loc == 0x02 ? 28 : 24) ;
+}
+
+int conv_dpm (MDS *mds, DPM *dpm, unsigned int *raw)
+{
+     // raw holds two zero words followed by every sample of the file
+
+     diff_dpm (dpm, raw, 0, mds->smp) ;
+
      dpm[0].var = 0 ;
 
-     for (int i = 1 ; i < mds->smp ; i++)
+     return 0 ;
+}
+
+int skim_dpm (FILE *file, MDS *mds, DPM *dpm, unsigned int step)
+{
+     // one cumulative sample out of step, the difference of two of them
+     //  being the timing of all the samples in between
+
+     unsigned int offset = base_dpm (mds) ;
+
+     unsigned int prv_raw = 0 ;
+     unsigned int prv_tim = 0 ;
+
+     for (int k = 0 ; k < mds->smp / step ; k++)
      {
-          fread (&dpm[i].raw, 4, 1, file) ;
+          unsigned int raw = 0 ;
+
+          fseek (file, offset + ((k + 1) * step - 1) * 4, SEEK_SET) ;
+          if (fread (&raw, 4, 1, file) != 1)
+               raw = prv_raw ;
+
+          unsigned int tim = (raw - prv_raw) / step ;
+
+          dpm[k].raw = raw ;
+          dpm[k].tim = tim ;
+          dpm[k].var = k > 0 ? tim - prv_tim : 0 ;
 
-          dpm[i].tim = dpm[i].raw - dpm[i-1].raw ;
-          dpm[i].var = dpm[i].tim - dpm[i-1].tim ;
+          prv_raw = raw ;
+          prv_tim = tim ;
      }
 
      return 0 ;
 }
+
+int pull_mds (SRC *src, MDS *mds)
+{
+     // same as read_mds without seeking backwards
+
+     unsigned char head[MDS_HEAD] = {0} ;
+     unsigned char tail[MDS_BACK + MDS_NEXT] = {0} ;
+
+     read_src (src, head, MDS_HEAD) ;
+
+     unsigned int ptr = get_le (head + 0x54, 2) ;
+
+     if (ptr >= MDS_HEAD)
+     {
+          unsigned int start = ptr - MDS_BACK ;
+          unsigned int got = 0 ;
+
+          if (start < MDS_HEAD)
+          {
+               got = MDS_HEAD - start ;
+               memcpy (tail, head + start, got) ;
+          }
+          else skip_src (src, start - MDS_HEAD) ;
+
+          // stop right before the first sample
+
+          read_src (src, tail + got, MDS_BACK + 1 - got) ;
+
+          unsigned int size = tail[MDS_BACK] == 0x02 ? 28 : 24 ;
+
+          read_src (src, tail + MDS_BACK + 1, size - 1) ;
+     }
+
+     int error = load_mds (head, tail, mds) ;
+     if (error != 0)
+          fprintf (stderr, "%s\n", text_mds (error)) ;
+
+     return error ;
+}
+
+int pull_dpm (SRC *src, MDS *mds, DPM *dpm)
+{
+     unsigned int raw[4096 + 2] = {0} ;
+     unsigned int cnt = 0 ;
+
+     for (int i = 0 ; i < mds->smp ; i += cnt)
+     {
+          cnt = mds->smp - i ;
+          if (cnt > 4096)
+               cnt = 4096 ;
+
+          if (read_src (src, raw + 2, cnt * 4) != cnt * 4)
+          {
+               fprintf (stderr, "Truncated DPM data\n") ;
+               return 1 ;
+          }
+
+          diff_dpm (dpm, raw, i, cnt) ;
+
+          raw[0] = raw[cnt] ;
+          raw[1] = raw[cnt+1] ;
+     }
+
+     dpm[0].var = 0 ;
+
+     return 0 ;
+}
@@ -24,10 +24,39 @@
 # include <stdlib.h>
 # include <string.h>
 
+# if LINUX
+# include <unistd.h>
+# endif
+
 # include "type.h"
+# include "arena.h"
+# include "stream.h"
+
+// header regions read before the DPM block
 
-int get_name (char *path, char **name) ;
+# define MDS_HEAD 0x170
+# define MDS_BACK 128
+# define MDS_NEXT 28
+
+static unsigned long get_le (unsigned char *byte, int len) ;
+static int load_mds (unsigned char *head, unsigned char *tail, MDS *mds) ;
+KERNEL static int diff_dpm (DPM *dpm, unsigned int *raw, int smp_stt, int count) ;
+
+int get_name (char *path, char **name, ARN *arn) ;
+char *text_mds (int error) ;
 int read_mds (FILE *file, MDS *mds) ;
+DPM *make_dpm (ARN *arn, unsigned int smp) ;
 int read_dpm (FILE *file, MDS *mds, DPM *dpm) ;
+int view_mds (unsigned char *head, unsigned char *tail, MDS *mds) ;
+unsigned int tail_mds (unsigned char *head) ;
+unsigned int base_dpm (MDS *mds) ;
+int conv_dpm (MDS *mds, DPM *dpm, unsigned int *raw) ;
+int skim_dpm (FILE *file, MDS *mds, DPM *dpm, unsigned int step) ;
+int pull_mds (SRC *src, MDS *mds) ;
+int pull_dpm (SRC *src, MDS *mds, DPM *dpm) ;
+
+# if LINUX
+int peek_mds (int fd, MDS *mds) ;
+# endif
 
 # endif
@@ -0,0 +1,142 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "ring.h"
+
+// submission and completion queues shared with the kernel,
+//  reads of many files are queued together and reaped as they end
+
+int make_rng (RNG *rng, unsigned int depth)
+{
+     struct io_uring_params par = {0} ;
+
+     memset (rng, 0, sizeof (RNG)) ;
+
+     rng->fd = syscall (__NR_io_uring_setup, depth, &par) ;
+     if (rng->fd < 0)
+          return 1 ;
+
+     rng->sq_len = par.sq_off.array + par.sq_entries * sizeof (unsigned int) ;
+     rng->cq_len = par.cq_off.cqes + par.cq_entries * sizeof (struct io_uring_cqe) ;
+
+     bool single = par.features & IORING_FEAT_SINGLE_MMAP ;
+
+     if (single && rng->cq_len > rng->sq_len)
+          rng->sq_len = rng->cq_len ;
+
+     rng->sq_ptr = mmap (NULL, rng->sq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rng->fd, IORING_OFF_SQ_RING) ;
+     if (rng->sq_ptr == MAP_FAILED)
+          { rng->sq_ptr = NULL ; free_rng (rng) ; return 2 ; }
+
+     if (single)
+          rng->cq_ptr = rng->sq_ptr ;
+     else
+     {
+          rng->cq_ptr = mmap (NULL, rng->cq_len, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rng->fd, IORING_OFF_CQ_RING) ;
+          if (rng->cq_ptr == MAP_FAILED)
+               { rng->cq_ptr = NULL ; free_rng (rng) ; return 2 ; }
+     }
+
+     rng->sqe_cnt = par.sq_entries ;
+     rng->sqe = mmap (NULL, par.sq_entries * sizeof (struct io_uring_sqe), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, rng->fd, IORING_OFF_SQES) ;
+     if (rng->sqe == MAP_FAILED)
+          { rng->sqe = NULL ; free_rng (rng) ; return 2 ; }
+
+     rng->sq_head = (unsigned int *) (rng->sq_ptr + par.sq_off.head) ;
+     rng->sq_tail = (unsigned int *) (rng->sq_ptr + par.sq_off.tail) ;
+     rng->sq_mask = (unsigned int *) (rng->sq_ptr + par.sq_off.ring_mask) ;
+     rng->sq_list = (unsigned int *) (rng->sq_ptr + par.sq_off.array) ;
+     rng->cq_head = (unsigned int *) (rng->cq_ptr + par.cq_off.head) ;
+     rng->cq_tail = (unsigned int *) (rng->cq_ptr + par.cq_off.tail) ;
+     rng->cq_mask = (unsigned int *) (rng->cq_ptr + par.cq_off.ring_mask) ;
+     rng->cqe = (struct io_uring_cqe *) (rng->cq_ptr + par.cq_off.cqes) ;
+
+     return 0 ;
+}
+
+int push_rng (RNG *rng, int fd, void *buf, unsigned int len, unsigned long off, unsigned long tag)
+{
+     unsigned int tail = *rng->sq_tail ;
+     unsigned int head = __atomic_load_n (rng->sq_head, __ATOMIC_ACQUIRE) ;
+
+     if (tail - head == rng->sqe_cnt)
+          return 1 ;
+
+     unsigned int idx = tail & *rng->sq_mask ;
+     struct io_uring_sqe *sqe = &rng->sqe[idx] ;
+
+     memset (sqe, 0, sizeof (*sqe)) ;
+
+     sqe->opcode = IORING_OP_READ ;
+     sqe->fd = fd ;
+     sqe->addr = (unsigned long) buf ;
+     sqe->len = len ;
+     sqe->off = off ;
+     sqe->user_data = tag ;
+
+     rng->sq_list[idx] = idx ;
+
+     __atomic_store_n (rng->sq_tail, tail + 1, __ATOMIC_RELEASE) ;
+
+     rng->pend += 1 ;
+
+     return 0 ;
+}
+
+int wait_rng (RNG *rng, unsigned long *tag, int *res)
+{
+     // queued reads are submitted while waiting for the next completion
+
+     unsigned int head = *rng->cq_head ;
+
+     while (head == __atomic_load_n (rng->cq_tail, __ATOMIC_ACQUIRE))
+     {
+          int done = syscall (__NR_io_uring_enter, rng->fd, rng->pend, 1, IORING_ENTER_GETEVENTS, NULL, 0) ;
+
+          if (done < 0 && errno == EINTR)
+               continue ;
+          if (done < 0)
+               return 1 ;
+
+          rng->pend -= done < rng->pend ? done : rng->pend ;
+     }
+
+     struct io_uring_cqe *cqe = &rng->cqe[head & *rng->cq_mask] ;
+
+     *tag = cqe->user_data ;
+     *res = cqe->res ;
+
+     __atomic_store_n (rng->cq_head, head + 1, __ATOMIC_RELEASE) ;
+
+     return 0 ;
+}
+
+void free_rng (RNG *rng)
+{
+     if (rng->sqe != NULL)
+          munmap (rng->sqe, rng->sqe_cnt * sizeof (struct io_uring_sqe)) ;
+     if (rng->cq_ptr != NULL && rng->cq_ptr != rng->sq_ptr)
+          munmap (rng->cq_ptr, rng->cq_len) ;
+     if (rng->sq_ptr != NULL)
+          munmap (rng->sq_ptr, rng->sq_len) ;
+     if (rng->fd > 0)
+          close (rng->fd) ;
+
+     memset (rng, 0, sizeof (RNG)) ;
+}
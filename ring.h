@@ -0,0 +1,59 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef RING_H
+# define RING_H
+
+# include <stdlib.h>
+# include <string.h>
+# include <errno.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <linux/io_uring.h>
+
+# include "type.h"
+
+typedef struct rng
+{
+     int fd ;
+     unsigned int pend ;
+     unsigned char *sq_ptr ;
+     unsigned char *cq_ptr ;
+     size_t sq_len ;
+     size_t cq_len ;
+     unsigned int *sq_head ;
+     unsigned int *sq_tail ;
+     unsigned int *sq_mask ;
+     unsigned int *sq_list ;
+     unsigned int *cq_head ;
+     unsigned int *cq_tail ;
+     unsigned int *cq_mask ;
+     struct io_uring_sqe *sqe ;
+     struct io_uring_cqe *cqe ;
+     unsigned int sqe_cnt ;
+}
+RNG ;
+
+int make_rng (RNG *rng, unsigned int depth) ;
+int push_rng (RNG *rng, int fd, void *buf, unsigned int len, unsigned long off, unsigned long tag) ;
+int wait_rng (RNG *rng, unsigned long *tag, int *res) ;
+void free_rng (RNG *rng) ;
+
+# endif
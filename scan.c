@@ -19,9 +19,9 @@
 
 # include "scan.h"
 
-static int seek_brk (MDS *mds, DPM *dpm, DSC *dsc)
+int seek_brk (MDS *mds, DPM *dpm, DSC *dsc)
 {
-     if (mds->cd || mds->lay < 2)
+     if (mds->cd || mds->lay < 2 || mds->smp < 2)
           return 1 ;
 
      // inferior and superior limits of the layer break area
@@ -29,7 +29,13 @@ static int seek_brk (MDS *mds, DPM *dpm, DSC *dsc)
      unsigned int smp_inf = (mds->sct / 2) / mds->itv - 1 ;
      unsigned int smp_sup = (2294922) / mds->itv - 1 ;
 
-     unsigned int brk_tim = dpm[smp_inf].tim ;
+     // header sizes larger than the measure would read past the samples,
+     //  and the second layer keeps at least one sample
+
+     if (smp_sup >= mds->smp - 1)
+          smp_sup = mds->smp - 2 ;
+
+     unsigned int brk_tim = smp_inf <= smp_sup ? dpm[smp_inf].tim : 0 ;
 
      for (int i = smp_inf ; i <= smp_sup ; i++)
      {
@@ -53,83 +59,238 @@ static int seek_brk (MDS *mds, DPM *dpm, DSC *dsc)
      return 0 ;
 }
 
-static int seek_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer)
+static inline __attribute__ ((always_inline)) int scan_spk (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp,
+                                                             const unsigned int itv, const signed int var_min, const signed int var_max)
 {
-     unsigned int var_min = 0 ;
-     unsigned int var_max = 0 ;
+     // inlined once per interval with constant thresholds, see seek_spk_256 and others
 
-     switch (mds->itv)
+     unsigned char cls[1024] ;
+     unsigned int next = smp_stt ;
+
+     for (int stt = smp_stt ; stt <= smp_stp ; stt += sizeof (cls))
      {
-          case 256 :
-               var_min = 10 ;
-               var_max = 60 ;
-               break ;
-          case 500 :
-          case 2048 :
-               var_min = 100 ;
-               var_max = 400 ;
-               break ;
+          int count = smp_stp - stt + 1 ;
+          if (count > sizeof (cls))
+               count = sizeof (cls) ;
+
+          // classify and sum the whole block without branching
+          //  1 : increase  2 : decrease
+
+          unsigned int sum = 0 ;
+
+          for (int k = 0 ; k < count ; k++)
+          {
+               signed int var = dpm[stt+k].var ;
+
+               cls[k] = ((var > var_min) & (var < var_max)) | ((var < -var_min) & (var > -var_max)) << 1 ;
+               sum += abs (var) ;
+          }
+
+          dsc->var_sum += sum ;
+
+          for (int k = 0 ; k < count ; k++)
+          {
+               unsigned long word = 0 ;
+
+               if (k + 8 <= count)
+               {
+                    memcpy (&word, cls + k, 8) ;
+                    if (word == 0)
+                         { k += 7 ; continue ; }
+               }
+
+               int i = stt + k ;
+
+               // the sample following a spike is skipped
+
+               if (cls[k] == 0 || i < next)
+                    continue ;
+
+               unsigned long sector = (unsigned long) (i + 1) * itv ;
+
+               // spike increase detection
+
+               if (cls[k] == 1)
+               {
+                    if (dsc->inc_cnt == 200)
+                    {
+                         fprintf (stderr, "Abnormal increase count\n") ;
+                         return 2 ;
+                    }
+
+                    dsc->inc_lba[dsc->inc_cnt] = sector ;
+                    dsc->inc_cnt += 1 ;
+               }
+
+               // spike decrease detection
+
+               if (cls[k] == 2)
+               {
+                    if (dsc->dec_cnt == 200)
+                    {
+                         fprintf (stderr, "Abnormal decrease count\n") ;
+                         return 2 ;
+                    }
+
+                    dsc->dec_lba[dsc->dec_cnt] = sector ;
+                    dsc->dec_cnt += 1 ;
+               }
+
+               dsc->var_sum -= abs (dpm[i].var) ;
+               if (i + 1 <= smp_stp)
+                    dsc->var_sum -= abs (dpm[i+1].var) ;
+
+               next = i + 2 ;
+          }
      }
 
-     unsigned int smp_stt = 0 ;
-     unsigned int smp_stp = mds->smp - 1 ;
+     return 0 ;
+}
 
-     switch (layer)
+KERNEL static int seek_spk_256 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp)
+{
+     return scan_spk (dpm, dsc, smp_stt, smp_stp, 256, 10, 60) ;
+}
+
+KERNEL static int seek_spk_500 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp)
+{
+     return scan_spk (dpm, dsc, smp_stt, smp_stp, 500, 100, 400) ;
+}
+
+KERNEL static int seek_spk_2048 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp)
+{
+     return scan_spk (dpm, dsc, smp_stt, smp_stp, 2048, 100, 400) ;
+}
+
+static int seek_spk_ada (MDS *mds, DPM *dpm, DSC *dsc, int smp_stt, int smp_stp, OSW *osw)
+{
+     // spikes are measured against the median of the previous samples,
+     //  so a drifting baseline does not move them out of the window,
+     //  and must stand out of five deviations of a noisy measure
+
+     signed int var_min = 100 ;
+     signed int var_max = 400 ;
+     unsigned int skip = 1 ;
+
+     switch (mds->itv)
      {
-          case 0 :
-               smp_stt = 0 ;
-               smp_stp = dsc->brk_smp ;
+          case 50 :
+               var_min = 3 ;
+               var_max = 33 ;
+               skip = 2 ;
                break ;
-          case 1 :
-               smp_stt = dsc->brk_smp + 1 ;
-               smp_stp = mds->smp - 1 ;
+          case 256 :
+               var_min = 10 ;
+               var_max = 60 ;
                break ;
      }
 
-     unsigned long sector = smp_stt * mds->itv ;
-     dsc->var_sum = 0 ;
+     rset_osw (osw) ;
+
+     unsigned int next = smp_stt ;
 
      for (int i = smp_stt ; i <= smp_stp ; i++)
      {
-          sector += mds->itv ;
+          signed int var = dpm[i].var ;
+          signed int dif = var - osw->med ;
+
+          // median absolute deviation scaled to a standard deviation
+
+          signed int lim = osw->mad * 7413 / 1000 ;
+          if (lim < var_min)
+               lim = var_min ;
+
+          signed int top = var_max + lim - var_min ;
+
+          push_osw (osw, var) ;
+
+          dsc->var_sum += abs (var) ;
+
+          if (i < next)
+          {
+               dsc->var_sum -= abs (var) ;
+               continue ;
+          }
+
+          unsigned long sector = (unsigned long) (i + 1) * mds->itv ;
 
           // spike increase detection
 
-          if (dpm[i].var > var_min && dpm[i].var < var_max)
+          if (dif > lim && dif < top)
           {
                if (dsc->inc_cnt == 200)
                {
-                    fprintf (stderr, "Abnormal increase count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
+                    fprintf (stderr, "Abnormal increase count\n") ;
+                    return 2 ;
                }
 
                dsc->inc_lba[dsc->inc_cnt] = sector ;
                dsc->inc_cnt += 1 ;
-               i += 1 ;
-               sector += mds->itv ;
-               continue ;
           }
 
           // spike decrease detection
 
-          if (dpm[i].var < -var_min && dpm[i].var > -var_max)
+          else if (dif < -lim && dif > -top)
           {
                if (dsc->dec_cnt == 200)
                {
-                    fprintf (stderr, "Abnormal decrease count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
+                    fprintf (stderr, "Abnormal decrease count\n") ;
+                    return 2 ;
                }
 
                dsc->dec_lba[dsc->dec_cnt] = sector ;
                dsc->dec_cnt += 1 ;
-               i += 1 ;
-               sector += mds->itv ;
-               continue ;
           }
 
-          dsc->var_sum += abs (dpm[i].var) ;
+          else continue ;
+
+          // the samples following a spike are skipped
+
+          dsc->var_sum -= abs (var) ;
+          next = i + 1 + skip ;
      }
 
+     return 0 ;
+}
+
+static int seek_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer, OSW *osw)
+{
+     unsigned int smp_stt = 0 ;
+     unsigned int smp_stp = mds->smp - 1 ;
+
+     switch (layer)
+     {
+          case 0 :
+               smp_stt = 0 ;
+               smp_stp = dsc->brk_smp ;
+               break ;
+          case 1 :
+               smp_stt = dsc->brk_smp + 1 ;
+               smp_stp = mds->smp - 1 ;
+               break ;
+     }
+
+     int state = 0 ;
+     dsc->var_sum = 0 ;
+
+     if (osw != NULL)
+          state = seek_spk_ada (mds, dpm, dsc, smp_stt, smp_stp, osw) ;
+     else switch (mds->itv)
+     {
+          case 256 :
+               state = seek_spk_256 (dpm, dsc, smp_stt, smp_stp) ;
+               break ;
+          case 500 :
+               state = seek_spk_500 (dpm, dsc, smp_stt, smp_stp) ;
+               break ;
+          case 2048 :
+               state = seek_spk_2048 (dpm, dsc, smp_stt, smp_stp) ;
+               break ;
+     }
+
+     if (state != 0)
+          return state ;
+
      dsc->var_rat = (float) abs (dpm[smp_stt].tim - dpm[smp_stp].tim) * 100 / dsc->var_sum ;
 
      switch (layer)
@@ -147,98 +308,216 @@ static int seek_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer)
      return 0 ;
 }
 
-static int seek_spk_50 (MDS *mds, DPM *dpm, DSC *dsc)
+KERNEL static int mark_glt (DPM *dpm, unsigned char *cls, int smp_stt, int count, signed int lim)
 {
-     unsigned long sector = 0 ;
+     // a glitch is a single sample far from both neighbours in the same direction,
+     //  the neighbours staying close to each other, as a drive retry or a read stall
+     // timings only, the variations being changed by the pass
 
-     for (int i = 0 ; i < mds->smp ; i++)
+     for (int k = 0 ; k < count ; k++)
      {
-          sector += mds->itv ;
+          DPM *cur = dpm + smp_stt + k ;
 
-          // spike increase detection
+          signed int bef = cur[0].tim - cur[-1].tim ;
+          signed int aft = cur[1].tim - cur[0].tim ;
+
+          cls[k] = (((bef > lim) & (aft < -lim)) | ((bef < -lim) & (aft > lim))) & (abs (bef + aft) <= lim / 2) ;
+     }
+
+     return 0 ;
+}
+
+static unsigned int seek_glt (MDS *mds, DPM *dpm, int mode)
+{
+     // beyond the largest variation of a spike
 
-          if (dpm[i].var > 3 && dpm[i].var < 33 && dpm[i].var + dpm[i+1].var > 13)
+     signed int lim = 400 ;
+
+     switch (mds->itv)
+     {
+          case 50 :
+               lim = 33 ;
+               break ;
+          case 256 :
+               lim = 60 ;
+               break ;
+     }
+
+     unsigned char cls[1024] ;
+     unsigned int next = 1 ;
+     unsigned int count = 0 ;
+
+     // first and last samples have a single neighbour
+
+     for (int stt = 1 ; stt < (signed int) mds->smp - 1 ; stt += sizeof (cls))
+     {
+          int size = mds->smp - 1 - stt ;
+          if (size > sizeof (cls))
+               size = sizeof (cls) ;
+
+          mark_glt (dpm, cls, stt, size, lim) ;
+
+          for (int k = 0 ; k < size ; k++)
           {
-               // false positive caused by variation artifact
+               unsigned long word = 0 ;
 
-               if (dpm[i-2].var + dpm[i-1].var < -9 || dpm[i+2].var + dpm[i+3].var < -9)
+               if (k + 8 <= size)
                {
-                    dsc->err_cnt += 1 ;
-                    dsc->var_sum += abs (dpm[i].var) ;
-                    continue ;
+                    memcpy (&word, cls + k, 8) ;
+                    if (word == 0)
+                         { k += 7 ; continue ; }
                }
 
-               // false positive caused by previous increase
+               int i = stt + k ;
 
-               if (dpm[i-1].var > 9)
-               {
-                    dsc->err_cnt += 1 ;
-                    dsc->var_sum += abs (dpm[i].var) ;
+               if (cls[k] == 0 || i < next)
                     continue ;
-               }
 
-               // true positive
-               // now determining the first increase sector
+               // the step over the glitch is kept on its sample,
+               //  the timings giving back the variations afterwards
 
-               if (dsc->inc_cnt == 200)
+               switch (mode)
                {
-                    fprintf (stderr, "Abnormal increase count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
+                    case GLT_DROP :
+                         dpm[i].var = (signed int) (dpm[i+1].tim - dpm[i-1].tim) ;
+                         dpm[i+1].var = 0 ;
+                         break ;
+                    case GLT_BACK :
+                         dpm[i].var = (signed int) (dpm[i].tim - dpm[i-1].tim) ;
+                         dpm[i+1].var = (signed int) (dpm[i+1].tim - dpm[i].tim) ;
+                         break ;
                }
 
-               dsc->inc_lba[dsc->inc_cnt] = sector ;
-               dsc->inc_cnt += 1 ;
-               i += 2 ;
-               sector += mds->itv * 2 ;
-               continue ;
+               count += 1 ;
+               next = i + 2 ;
           }
+     }
 
-          // spike decrease detection
+     return count ;
+}
+
+KERNEL static int mark_spk_50 (DPM *dpm, unsigned char *cls, int smp_stt, int count, unsigned int *var_sum)
+{
+     // classify every sample of the block without branching
+     //  0 : no spike
+     //  1 : increase  2 : increase false positive
+     //  3 : decrease  4 : decrease false positive
+     // neighbours out of the file are zero variation guard samples
+
+     unsigned int sum = 0 ;
+
+     for (int k = 0 ; k < count ; k++)
+     {
+          DPM *cur = dpm + smp_stt + k ;
+
+          signed int var = cur[0].var ;
+          signed int bef = cur[-2].var + cur[-1].var ;
+          signed int aft = cur[2].var + cur[3].var ;
+          signed int pair = var + cur[1].var ;
 
-          if (dpm[i].var < -3 && dpm[i].var > -33 && dpm[i].var + dpm[i+1].var < -13)
+          unsigned char inc = (var > 3) & (var < 33) & (pair > 13) ;
+          unsigned char dec = (var < -3) & (var > -33) & (pair < -13) ;
+
+          // false positive caused by variation artifact or by previous spike
+
+          unsigned char inc_err = (bef < -9) | (aft < -9) | (cur[-1].var > 9) ;
+          unsigned char dec_err = (bef > 9) | (aft > 9) | (cur[-1].var < -9) ;
+
+          cls[k] = inc * (1 + inc_err) + dec * (3 + dec_err) ;
+          sum += abs (var) ;
+     }
+
+     *var_sum += sum ;
+
+     return 0 ;
+}
+
+static int seek_spk_50 (MDS *mds, DPM *dpm, DSC *dsc)
+{
+     unsigned char cls[1024] ;
+     unsigned int next = 0 ;
+
+     for (int stt = 0 ; stt < mds->smp ; stt += sizeof (cls))
+     {
+          int count = mds->smp - stt ;
+          if (count > sizeof (cls))
+               count = sizeof (cls) ;
+
+          mark_spk_50 (dpm, cls, stt, count, &dsc->var_sum) ;
+
+          for (int k = 0 ; k < count ; k++)
           {
-               // false positive caused by variation artifact
+               // skip eight quiet samples at once
+
+               unsigned long word = 0 ;
 
-               if (dpm[i-2].var + dpm[i-1].var > 9 || dpm[i+2].var + dpm[i+3].var > 9)
+               if (k + 8 <= count)
                {
-                    dsc->err_cnt += 1 ;
-                    dsc->var_sum += abs (dpm[i].var) ;
-                    continue ;
+                    memcpy (&word, cls + k, 8) ;
+                    if (word == 0)
+                         { k += 7 ; continue ; }
                }
 
-               // false positive caused by previous decrease
+               int i = stt + k ;
 
-               if (dpm[i-1].var < -9)
-               {
-                    dsc->err_cnt += 1 ;
-                    dsc->var_sum += abs (dpm[i].var) ;
+               // samples already part of a detected spike
+
+               if (cls[k] == 0 || i < next)
                     continue ;
-               }
 
-               // true positive
-               // now determining the last decrease sector
+               unsigned long sector = (unsigned long) (i + 1) * mds->itv ;
 
-               if (dsc->dec_cnt == 200)
+               switch (cls[k])
                {
-                    fprintf (stderr, "Abnormal decrease count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
-               }
+                    case 2 :
+                    case 4 :
+                         dsc->err_cnt += 1 ;
+                         break ;
 
-               dsc->dec_lba[dsc->dec_cnt] = sector ;
+                    case 1 :
+                         // true positive
+                         // now determining the first increase sector
 
-               if (dpm[i+1].var < -3)
-                    dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
+                         if (dsc->inc_cnt == 200)
+                         {
+                              fprintf (stderr, "Abnormal increase count\n") ;
+                              return 2 ;
+                         }
 
-               if (dpm[i+1].var < -3 && dpm[i+2].var < -3)
-                    dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
+                         dsc->inc_lba[dsc->inc_cnt] = sector ;
+                         dsc->inc_cnt += 1 ;
+                         break ;
 
-               dsc->dec_cnt += 1 ;
-               i += 2 ;
-               sector += mds->itv * 2 ;
-               continue ;
-          }
+                    case 3 :
+                         // true positive
+                         // now determining the last decrease sector
+
+                         if (dsc->dec_cnt == 200)
+                         {
+                              fprintf (stderr, "Abnormal decrease count\n") ;
+                              return 2 ;
+                         }
+
+                         dsc->dec_lba[dsc->dec_cnt] = sector ;
+
+                         if (dpm[i+1].var < -3)
+                              dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
 
-          dsc->var_sum += abs (dpm[i].var) ;
+                         if (dpm[i+1].var < -3 && dpm[i+2].var < -3)
+                              dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
+
+                         dsc->dec_cnt += 1 ;
+                         break ;
+               }
+
+               // a true spike covers three samples left out of the variation sum
+
+               if (cls[k] == 1 || cls[k] == 3)
+               {
+                    dsc->var_sum -= abs (dpm[i].var) + abs (dpm[i+1].var) + abs (dpm[i+2].var) ;
+                    next = i + 3 ;
+               }
+          }
      }
 
      dsc->var_rat = (float) (dpm[0].tim - dpm[mds->smp-1].tim) * 100 / dsc->var_sum ;
@@ -259,8 +538,8 @@ static int calc_inc_amp (MDS *mds, DPM *dpm, DSC *dsc)
 
 static int calc_dec_amp (MDS *mds, DPM *dpm, DSC *dsc)
 {
-     unsigned int fds = dsc->dec_lba[0] / mds->itv - 1 ;
-     unsigned int lds = dsc->dec_lba[dsc->dec_cnt-1] / mds->itv - 1 ;
+     signed int fds = dsc->dec_lba[0] / mds->itv - 1 ;
+     signed int lds = dsc->dec_lba[dsc->dec_cnt-1] / mds->itv - 1 ;
 
      dsc->dec_amp[0] = dpm[fds].var + dpm[fds-1].var + dpm[fds-2].var ;
      dsc->dec_amp[1] = dpm[lds].var + dpm[lds-1].var + dpm[lds-2].var ;
@@ -291,8 +570,8 @@ static int seek_reg (MDS *mds, DSC *dsc)
           {
                if (dsc->stt_cnt == 10)
                {
-                    fprintf (stderr, "Abnormal start count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
+                    fprintf (stderr, "Abnormal start count\n") ;
+                    return 2 ;
                }
 
                dsc->stt_lba[dsc->stt_cnt] = dsc->inc_lba[i] ;
@@ -308,8 +587,8 @@ static int seek_reg (MDS *mds, DSC *dsc)
           {
                if (dsc->stp_cnt == 9)
                {
-                    fprintf (stderr, "Abnormal stop count, exiting...\n") ;
-                    exit (EXIT_FAILURE) ;
+                    fprintf (stderr, "Abnormal stop count\n") ;
+                    return 2 ;
                }
 
                dsc->stp_lba[dsc->stp_cnt] = dsc->dec_lba[i-1] ;
@@ -413,14 +692,37 @@ static int eval_spk (DSC *dsc, SPK *spk)
      return 0 ;
 }
 
-int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk)
+int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk, OPT *opt, ARN *arn)
 {
+     int state = 0 ;
+
      seek_brk (mds, dpm, dsc) ;
 
-     if (mds->itv == 50)
+     // optional running median baseline instead of fixed windows
+
+     OSW win = {0} ;
+     OSW *osw = NULL ;
+
+     if (opt->win != 0)
+     {
+          if (make_osw (&win, opt->win, arn) != 0)
+               return 2 ;
+
+          osw = &win ;
+          dsc->ada_win = opt->win ;
+     }
+
+     // isolated outliers counted, and optionally left out of the sums and spikes
+
+     dsc->glt_cnt = seek_glt (mds, dpm, opt->glitch ? GLT_DROP : GLT_FIND) ;
+     dsc->glt_off = opt->glitch ;
+
+     unsigned long tick = time_met () ;
+
+     if (mds->itv == 50 && osw == NULL)
      {
           dsc->tim_avg = dpm[mds->smp-1].raw / mds->smp ;
-          seek_spk_50 (mds, dpm, dsc) ;
+          state |= seek_spk_50 (mds, dpm, dsc) ;
      }
      else switch (mds->lay)
      {
@@ -428,32 +730,58 @@ int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk)
           case 1 :
                // analyze whole disc
                dsc->tim_avg = dpm[mds->smp-1].raw / mds->smp ;
-               seek_spk (mds, dpm, dsc, -1) ;
+               state |= seek_spk (mds, dpm, dsc, -1, osw) ;
                break ;
           case 2 :
                // analyze layer # 0
                dsc->lay_0_avg = dpm[dsc->brk_smp].raw / (dsc->brk_smp+1) ;
-               seek_spk (mds, dpm, dsc, 0) ;
+               state |= seek_spk (mds, dpm, dsc, 0, osw) ;
                // analyze layer # 1
                dsc->lay_1_avg = (dpm[mds->smp-1].raw - dpm[dsc->brk_smp].raw) / (mds->smp - (dsc->brk_smp+1)) ;
-               seek_spk (mds, dpm, dsc, 1) ;
+               state |= seek_spk (mds, dpm, dsc, 1, osw) ;
                break ;
      }
 
+     if (opt->glitch)
+          seek_glt (mds, dpm, GLT_BACK) ;
+
+     if (state != 0)
+          return 3 ;
+
+     if (opt->tpl != NULL)
+          dsc->spk_tim = time_met () - tick ;
+
+     // spread of the timings and variations of each layer
+
+     if (dist_dpm (mds, dpm, dsc, arn) == 2)
+          return 2 ;
+
      if (dsc->inc_cnt)
           calc_inc_amp (mds, dpm, dsc) ;
      if (dsc->dec_cnt)
           calc_dec_amp (mds, dpm, dsc) ;
 
-     seek_reg (mds, dsc) ;
+     if (seek_reg (mds, dsc) != 0)
+          return 3 ;
+
+     // regions found on the timing curve, reported beside the spike ones
+
+     if (split_dpm (mds, dpm, dsc, mds->itv, arn) == 2)
+          return 2 ;
 
      dsc->dpm_cat = eval_reg (dsc) ;
+
+     // matched filter beside the rules, learning from the good dumps
+
+     if (opt->tpl != NULL && mtch_dpm (mds, dpm, dsc, opt->tpl, arn) == 2)
+          return 2 ;
+
      if (dsc->dpm_cat != 0)
           return 1 ;
 
      unsigned char spr_cnt = dsc->dec_cnt / dsc->stp_cnt ;
 
-     *spk = calloc (spr_cnt, sizeof (SPK)) ;
+     *spk = take_arn (arn, spr_cnt * sizeof (SPK)) ;
      if (*spk == NULL)
           return 2 ;
 
@@ -461,3 +789,34 @@ int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk)
 
      return 0 ;
 }
+
+int eval_pre (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn)
+{
+     // rough pass over samples averaged from the given interval,
+     //  break, timings and regions only
+
+     seek_brk (mds, dpm, dsc) ;
+
+     unsigned long sum = 0 ;
+
+     for (int i = 0 ; i < mds->smp ; i++)
+     {
+          sum += dpm[i].tim ;
+
+          if (mds->lay == 2 && i == dsc->brk_smp)
+          {
+               dsc->lay_0_avg = sum / (i + 1) ;
+               sum = 0 ;
+          }
+     }
+
+     if (mds->lay == 2)
+          dsc->lay_1_avg = sum / (mds->smp - (dsc->brk_smp + 1)) ;
+     else
+          dsc->tim_avg = sum / mds->smp ;
+
+     if (split_dpm (mds, dpm, dsc, itv, arn) == 2)
+          return 2 ;
+
+     return 0 ;
+}
@@ -22,12 +22,33 @@
 
 # include <stdio.h>
 # include <stdlib.h>
+# include <string.h>
 # include <math.h>
 
 # include "type.h"
-
-static int seek_brk (MDS *mds, DPM *dpm, DSC *dsc) ;
-static int seek_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer) ;
+# include "arena.h"
+# include "order.h"
+# include "split.h"
+# include "hist.h"
+# include "match.h"
+
+// glitch pass, counting only, leaving the glitches out of the variations
+//  or putting them back
+
+# define GLT_FIND 0
+# define GLT_DROP 1
+# define GLT_BACK 2
+
+static inline int scan_spk (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp,
+                            const unsigned int itv, const signed int var_min, const signed int var_max) ;
+KERNEL static int seek_spk_256 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp) ;
+KERNEL static int seek_spk_500 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp) ;
+KERNEL static int seek_spk_2048 (DPM *dpm, DSC *dsc, int smp_stt, int smp_stp) ;
+static int seek_spk_ada (MDS *mds, DPM *dpm, DSC *dsc, int smp_stt, int smp_stp, OSW *osw) ;
+static int seek_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer, OSW *osw) ;
+KERNEL static int mark_glt (DPM *dpm, unsigned char *cls, int smp_stt, int count, signed int lim) ;
+static unsigned int seek_glt (MDS *mds, DPM *dpm, int mode) ;
+KERNEL static int mark_spk_50 (DPM *dpm, unsigned char *cls, int smp_stt, int count, unsigned int *var_sum) ;
 static int seek_spk_50 (MDS *mds, DPM *dpm, DSC *dsc) ;
 static int calc_inc_amp (MDS *mds, DPM *dpm, DSC *dsc) ;
 static int calc_dec_amp (MDS *mds, DPM *dpm, DSC *dsc) ;
@@ -35,6 +56,8 @@ static int seek_reg (MDS *mds, DSC *dsc) ;
 static int eval_reg (DSC *dsc) ;
 static int eval_spk (DSC *dsc, SPK *spk) ;
 
-int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk) ;
+int seek_brk (MDS *mds, DPM *dpm, DSC *dsc) ;
+int eval_dpm (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk, OPT *opt, ARN *arn) ;
+int eval_pre (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn) ;
 
 # endif
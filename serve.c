@@ -0,0 +1,679 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "serve.h"
+
+// resident analysis over a unix socket, one request per line :
+//
+//   SUM path                  statistics and regions
+//   SPK path                  spikes of every region
+//   WIN sector count path     samples from a sector on
+//   BMP path                  rendered chart
+//   MFD path                  samples and analysis in a sealed memory file,
+//                             its descriptor passed along an empty answer
+//
+// answered by "OK length" and the body, or by "ERR message"
+
+static volatile sig_atomic_t halt = 0 ;
+
+static unsigned long hash_path (char *path)
+{
+     unsigned long hash = 14695981039346656037UL ;
+
+     for (unsigned char *ptr = (unsigned char *) path ; *ptr != 0 ; ptr++)
+          hash = (hash ^ *ptr) * 1099511628211UL ;
+
+     return hash ;
+}
+
+static void free_ent (ENT *ent)
+{
+     free_arn (&ent->arn) ;
+     shut_sto (&ent->sto) ;
+
+     if (ent->bmp != NULL)
+          free (ent->bmp) ;
+     if (ent->spk_txt != NULL)
+          free (ent->spk_txt) ;
+     if (ent->sum != NULL)
+          free (ent->sum) ;
+     if (ent->path != NULL)
+          free (ent->path) ;
+
+     free (ent) ;
+}
+
+static ENT *load_ent (char *path, struct stat *info, OPT *opt, char **text)
+{
+     FILE *file = NULL ;
+     ENT *ent = NULL ;
+
+     ent = calloc (1, sizeof (ENT)) ;
+     if (ent == NULL)
+          { *text = "No memory" ; goto fail ; }
+
+     ent->path = strdup (path) ;
+     ent->hash = hash_path (path) ;
+     ent->mtim = info->st_mtim ;
+     ent->size = info->st_size ;
+
+     if (ent->path == NULL)
+          { *text = "No memory" ; goto fail ; }
+
+     file = fopen (path, "rb") ;
+     if (file == NULL)
+          { *text = "No file" ; goto fail ; }
+
+     int error = read_mds (file, &ent->mds) ;
+     if (error != 0)
+          { *text = text_mds (error) ; goto fail ; }
+
+     if (make_arn (&ent->arn, size_arn (&ent->mds, opt, path), opt->huge) != 0)
+          { *text = "No memory" ; goto fail ; }
+
+     ent->dpm = make_dpm (&ent->arn, ent->mds.smp) ;
+     if (ent->dpm == NULL)
+          { *text = "No memory" ; goto fail ; }
+
+     read_dpm (file, &ent->mds, ent->dpm) ;
+
+     fclose (file) ;
+     file = NULL ;
+
+     int state = eval_dpm (&ent->mds, ent->dpm, &ent->dsc, &ent->spk, opt, &ent->arn) ;
+     if (state == 2 || state == 3)
+          { *text = "Analysis failed" ; goto fail ; }
+
+     // the text answers are written once, requests only send them
+
+     FILE *sum = open_memstream (&ent->sum, &ent->sum_len) ;
+     if (sum == NULL)
+          { *text = "No memory" ; goto fail ; }
+     save_sum (sum, &ent->mds, ent->dpm, &ent->dsc, ent->spk, false) ;
+     fclose (sum) ;
+
+     FILE *spk = open_memstream (&ent->spk_txt, &ent->spk_len) ;
+     if (spk == NULL)
+          { *text = "No memory" ; goto fail ; }
+     save_sum (spk, &ent->mds, ent->dpm, &ent->dsc, ent->spk, true) ;
+     fclose (spk) ;
+
+     ent->cost = sizeof (ENT) + ent->arn.size + ent->sum_len + ent->spk_len ;
+
+     return ent ;
+
+     fail :
+
+     if (file != NULL)
+          fclose (file) ;
+     if (ent != NULL)
+          free_ent (ent) ;
+
+     return NULL ;
+}
+
+static void drop_ent (LRU *lru, ENT *ent)
+{
+     // unlinked at once, freed by the last request using it
+
+     ENT **link = &lru->tab[ent->hash % SRV_TAB] ;
+
+     while (*link != ent)
+          link = &(*link)->next ;
+     *link = ent->next ;
+
+     if (ent->newer != NULL)
+          ent->newer->older = ent->older ;
+     else lru->head = ent->older ;
+
+     if (ent->older != NULL)
+          ent->older->newer = ent->newer ;
+     else lru->tail = ent->newer ;
+
+     lru->used -= ent->cost ;
+     ent->gone = true ;
+
+     if (ent->ref == 0)
+          free_ent (ent) ;
+}
+
+static void lift_ent (LRU *lru, ENT *ent)
+{
+     if (lru->head == ent)
+          return ;
+
+     // out of the list if already in, then first
+
+     if (ent->newer != NULL)
+          ent->newer->older = ent->older ;
+     if (ent->older != NULL)
+          ent->older->newer = ent->newer ;
+     else if (lru->tail == ent)
+          lru->tail = ent->newer ;
+
+     ent->newer = NULL ;
+     ent->older = lru->head ;
+
+     if (lru->head != NULL)
+          lru->head->newer = ent ;
+     lru->head = ent ;
+
+     if (lru->tail == NULL)
+          lru->tail = ent ;
+}
+
+static ENT *take_ent (LRU *lru, char *path, char **text)
+{
+     struct stat info = {0} ;
+
+     if (stat (path, &info) != 0)
+          { *text = "No file" ; return NULL ; }
+
+     unsigned long hash = hash_path (path) ;
+
+     // dumps written again since they were analyzed are analyzed anew
+
+     for (int pass = 0 ; pass < 2 ; pass++)
+     {
+          pthread_mutex_lock (&lru->lock) ;
+
+          ENT *ent = lru->tab[hash % SRV_TAB] ;
+
+          while (ent != NULL && (ent->hash != hash || strcmp (ent->path, path) != 0))
+               ent = ent->next ;
+
+          if (ent != NULL && (ent->size != info.st_size ||
+              ent->mtim.tv_sec != info.st_mtim.tv_sec || ent->mtim.tv_nsec != info.st_mtim.tv_nsec))
+          {
+               drop_ent (lru, ent) ;
+               ent = NULL ;
+          }
+
+          if (ent != NULL)
+          {
+               lift_ent (lru, ent) ;
+               ent->ref += 1 ;
+
+               pthread_mutex_unlock (&lru->lock) ;
+
+               return ent ;
+          }
+
+          pthread_mutex_unlock (&lru->lock) ;
+
+          if (pass == 1)
+               break ;
+
+          // analyzed without the lock, a concurrent request for the same dump
+          //  may have inserted it meanwhile
+
+          ENT *load = load_ent (path, &info, lru->opt, text) ;
+          if (load == NULL)
+               return NULL ;
+
+          pthread_mutex_lock (&lru->lock) ;
+
+          ent = lru->tab[hash % SRV_TAB] ;
+
+          while (ent != NULL && (ent->hash != hash || strcmp (ent->path, path) != 0))
+               ent = ent->next ;
+
+          if (ent != NULL)
+          {
+               pthread_mutex_unlock (&lru->lock) ;
+               free_ent (load) ;
+               continue ;
+          }
+
+          load->next = lru->tab[hash % SRV_TAB] ;
+          lru->tab[hash % SRV_TAB] = load ;
+          lift_ent (lru, load) ;
+
+          load->ref = 1 ;
+          lru->used += load->cost ;
+
+          // least recently used entries leave until the cache fits again
+
+          while (lru->used > lru->cap && lru->tail != load)
+               drop_ent (lru, lru->tail) ;
+
+          pthread_mutex_unlock (&lru->lock) ;
+
+          return load ;
+     }
+
+     *text = "Busy" ;
+
+     return NULL ;
+}
+
+static void give_ent (LRU *lru, ENT *ent)
+{
+     pthread_mutex_lock (&lru->lock) ;
+
+     ent->ref -= 1 ;
+
+     if (ent->gone && ent->ref == 0)
+          free_ent (ent) ;
+
+     pthread_mutex_unlock (&lru->lock) ;
+}
+
+static int send_ans (int fd, void *body, size_t len)
+{
+     char head[32] ;
+     int head_len = snprintf (head, sizeof (head), "OK %zu\n", len) ;
+
+     struct iovec part[2] = { {head, head_len}, {body, len} } ;
+     size_t left = head_len + len ;
+
+     // a single call unless the socket buffer fills
+
+     while (left > 0)
+     {
+          ssize_t done = writev (fd, part, 2) ;
+
+          if (done < 0 && errno == EINTR)
+               continue ;
+          if (done <= 0)
+               return 1 ;
+
+          left -= done ;
+
+          for (int i = 0 ; i < 2 ; i++)
+          {
+               size_t step = done < part[i].iov_len ? done : part[i].iov_len ;
+
+               part[i].iov_base = (char *) part[i].iov_base + step ;
+               part[i].iov_len -= step ;
+               done -= step ;
+          }
+     }
+
+     return 0 ;
+}
+
+static int send_err (int fd, char *text)
+{
+     char line[256] ;
+     int len = snprintf (line, sizeof (line), "ERR %s\n", text) ;
+
+     return write (fd, line, len) != len ;
+}
+
+static int answer (LRU *lru, int fd, char *line)
+{
+     char *text = NULL ;
+     char verb[4] = {0} ;
+
+     unsigned long sector = 0 ;
+     unsigned int count = 0 ;
+     int skip = 0 ;
+
+     if (strncmp (line, "WIN ", 4) == 0)
+     {
+          if (sscanf (line, "WIN %lu %u %n", &sector, &count, &skip) < 2 || skip == 0)
+               return send_err (fd, "Bad request") ;
+     }
+     else if (strlen (line) > 4 && line[3] == ' ')
+          skip = 4 ;
+     else return send_err (fd, "Bad request") ;
+
+     memcpy (verb, line, 3) ;
+
+     ENT *ent = take_ent (lru, line + skip, &text) ;
+     if (ent == NULL)
+          return send_err (fd, text) ;
+
+     int error = 0 ;
+
+     if (strcmp (verb, "SUM") == 0)
+          error = send_ans (fd, ent->sum, ent->sum_len) ;
+
+     else if (strcmp (verb, "SPK") == 0)
+          error = send_ans (fd, ent->spk_txt, ent->spk_len) ;
+
+     else if (strcmp (verb, "WIN") == 0)
+     {
+          char *body = NULL ;
+          size_t len = 0 ;
+
+          if (count > SRV_WIN)
+               count = SRV_WIN ;
+
+          FILE *file = open_memstream (&body, &len) ;
+
+          if (file == NULL)
+               error = send_err (fd, "No memory") ;
+          else if (save_win (file, &ent->mds, ent->dpm, &ent->dsc, sector, count) != 0)
+               { fclose (file) ; error = send_err (fd, "Sector out of range") ; }
+          else
+               { fclose (file) ; error = send_ans (fd, body, len) ; }
+
+          if (body != NULL)
+               free (body) ;
+     }
+
+     else if (strcmp (verb, "BMP") == 0)
+     {
+          // rendered by the first request asking for it, one at a time
+
+          pthread_mutex_lock (&lru->draw) ;
+
+          if (ent->bmp == NULL)
+          {
+               ent->bmp = pack_bmp (&ent->mds, ent->dpm, &ent->arn, &ent->bmp_len) ;
+
+               pthread_mutex_lock (&lru->lock) ;
+               ent->cost += ent->bmp_len ;
+               if (! ent->gone)
+                    lru->used += ent->bmp_len ;
+               pthread_mutex_unlock (&lru->lock) ;
+          }
+
+          pthread_mutex_unlock (&lru->draw) ;
+
+          if (ent->bmp == NULL)
+               error = send_err (fd, "Rendering failed") ;
+          else error = send_ans (fd, ent->bmp, ent->bmp_len) ;
+     }
+
+     else if (strcmp (verb, "MFD") == 0)
+     {
+          // sealed by the first request asking for it, then shared by every client
+
+          pthread_mutex_lock (&lru->seal) ;
+
+          if (ent->sto.base == NULL && make_sto (&ent->sto, &ent->mds, ent->dpm, &ent->dsc, ent->spk, ent->path) == 0)
+          {
+               pthread_mutex_lock (&lru->lock) ;
+               ent->cost += ent->sto.size ;
+               if (! ent->gone)
+                    lru->used += ent->sto.size ;
+               pthread_mutex_unlock (&lru->lock) ;
+          }
+
+          pthread_mutex_unlock (&lru->seal) ;
+
+          if (ent->sto.base == NULL)
+               error = send_err (fd, "Sharing failed") ;
+          else error = pass_sto (fd, ent->sto.fd, "OK 0\n") ;
+     }
+
+     else error = send_err (fd, "Bad request") ;
+
+     give_ent (lru, ent) ;
+
+     return error ;
+}
+
+static void *talk_srv (void *arg)
+{
+     CON *con = arg ;
+     LRU *lru = con->lru ;
+     int fd = con->fd ;
+
+     char buf[SRV_LINE] ;
+     size_t fill = 0 ;
+
+     free (con) ;
+
+     // idle clients are checked for the stop request every second
+
+     struct timeval wait = {1, 0} ;
+     setsockopt (fd, SOL_SOCKET, SO_RCVTIMEO, &wait, sizeof (wait)) ;
+
+     while (! halt)
+     {
+          ssize_t len = read (fd, buf + fill, sizeof (buf) - fill) ;
+
+          if (len < 0 && (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK))
+               continue ;
+          if (len <= 0)
+               break ;
+
+          fill += len ;
+
+          // every complete line is a request, the rest waits for more
+
+          char *line = buf ;
+          char *stop = NULL ;
+          bool fail = false ;
+
+          while (! fail && (stop = memchr (line, '\n', buf + fill - line)) != NULL)
+          {
+               *stop = 0 ;
+               if (stop > line && stop[-1] == '\r')
+                    stop[-1] = 0 ;
+
+               fail = answer (lru, fd, line) != 0 ;
+               line = stop + 1 ;
+          }
+
+          fill -= line - buf ;
+          memmove (buf, line, fill) ;
+
+          if (fill == sizeof (buf))
+               { send_err (fd, "Line too long") ; fail = true ; }
+
+          if (fail)
+               break ;
+     }
+
+     close (fd) ;
+
+     pthread_mutex_lock (&lru->lock) ;
+     lru->live -= 1 ;
+     pthread_cond_signal (&lru->idle) ;
+     pthread_mutex_unlock (&lru->lock) ;
+
+     return NULL ;
+}
+
+static void *work_srv (void *arg)
+{
+     LRU *lru = arg ;
+
+     pthread_attr_t attr ;
+     pthread_attr_init (&attr) ;
+     pthread_attr_setdetachstate (&attr, PTHREAD_CREATE_DETACHED) ;
+
+     // a thread for each client, idle connections never hold back the others
+
+     while (! halt)
+     {
+          int fd = accept (lru->fd, NULL, NULL) ;
+
+          if (fd < 0 && (errno == EINTR || errno == ECONNABORTED))
+               continue ;
+          if (fd < 0)
+               break ;
+
+          CON *con = malloc (sizeof (CON)) ;
+          pthread_t thread ;
+
+          if (con == NULL)
+               { close (fd) ; continue ; }
+
+          con->lru = lru ;
+          con->fd = fd ;
+
+          pthread_mutex_lock (&lru->lock) ;
+          lru->live += 1 ;
+          pthread_mutex_unlock (&lru->lock) ;
+
+          if (pthread_create (&thread, &attr, talk_srv, con) != 0)
+          {
+               close (fd) ;
+               free (con) ;
+
+               pthread_mutex_lock (&lru->lock) ;
+               lru->live -= 1 ;
+               pthread_mutex_unlock (&lru->lock) ;
+          }
+     }
+
+     pthread_attr_destroy (&attr) ;
+
+     return NULL ;
+}
+
+int serve (char *path, OPT *opt)
+{
+     LRU *lru = NULL ;
+     pthread_t thread ;
+     bool started = false ;
+     bool bound = false ;
+
+     int error = 0 ;
+
+     lru = calloc (1, sizeof (LRU)) ;
+     if (lru == NULL)
+          { error = 1 ; goto quit ; }
+
+     lru->cap = (size_t) (opt->mem ? opt->mem : SRV_CAP) << 20 ;
+     lru->opt = opt ;
+     lru->fd = -1 ;
+
+     struct sockaddr_un addr = {0} ;
+
+     if (strlen (path) >= sizeof (addr.sun_path))
+          { error = 2 ; goto quit ; }
+
+     addr.sun_family = AF_UNIX ;
+     strcpy (addr.sun_path, path) ;
+
+     lru->fd = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) ;
+     if (lru->fd < 0)
+          { error = 3 ; goto quit ; }
+
+     // a socket left by a previous run is replaced
+
+     unlink (path) ;
+
+     if (bind (lru->fd, (struct sockaddr *) &addr, sizeof (addr)) != 0 || listen (lru->fd, 64) != 0)
+          { error = 3 ; goto quit ; }
+
+     bound = true ;
+
+     pthread_mutex_init (&lru->lock, NULL) ;
+     pthread_mutex_init (&lru->draw, NULL) ;
+     pthread_mutex_init (&lru->seal, NULL) ;
+     pthread_cond_init (&lru->idle, NULL) ;
+
+     // clients leaving early must not kill the server, stop signals
+     //  are left to this thread
+
+     struct sigaction action = {0} ;
+
+     action.sa_handler = SIG_IGN ;
+     sigaction (SIGPIPE, &action, NULL) ;
+
+     sigset_t mask = {0} ;
+     sigset_t prev = {0} ;
+
+     sigemptyset (&mask) ;
+     sigaddset (&mask, SIGINT) ;
+     sigaddset (&mask, SIGTERM) ;
+     pthread_sigmask (SIG_BLOCK, &mask, &prev) ;
+
+     started = pthread_create (&thread, NULL, work_srv, lru) == 0 ;
+
+     int signal = 0 ;
+
+     if (started)
+          sigwait (&mask, &signal) ;
+
+     pthread_sigmask (SIG_SETMASK, &prev, NULL) ;
+
+     // accept fails once the socket is shut, idle clients leave within a second
+
+     halt = 1 ;
+     shutdown (lru->fd, SHUT_RDWR) ;
+
+     if (started)
+          pthread_join (thread, NULL) ;
+
+     pthread_mutex_lock (&lru->lock) ;
+
+     while (lru->live > 0)
+          pthread_cond_wait (&lru->idle, &lru->lock) ;
+
+     while (lru->tail != NULL)
+          drop_ent (lru, lru->tail) ;
+
+     pthread_mutex_unlock (&lru->lock) ;
+
+     pthread_cond_destroy (&lru->idle) ;
+     pthread_mutex_destroy (&lru->seal) ;
+     pthread_mutex_destroy (&lru->draw) ;
+     pthread_mutex_destroy (&lru->lock) ;
+
+     if (! started)
+          error = 4 ;
+
+     quit :
+
+     if (lru != NULL && lru->fd >= 0)
+          close (lru->fd) ;
+     if (bound)
+          unlink (path) ;
+
+     if (lru != NULL)
+          free (lru) ;
+
+     return error ;
+}
+
+int view (char *sock, char *path, OPT *opt)
+{
+     // chart of a dump held by a server, drawn straight from the sealed
+     //  pages it shares, without reading or analyzing the dump again
+
+     STO sto = {0} ;
+     ARN arn = {0} ;
+     char *name = NULL ;
+     char full[PATH_MAX] ;
+
+     int error = 0 ;
+
+     // the server resolves paths from its own directory
+
+     if (realpath (path, full) == NULL)
+          return 1 ;
+
+     if (join_sto (&sto, sock, full) != 0)
+          return 2 ;
+
+     if (make_arn (&arn, size_arn (sto.mds, opt, path), false) != 0)
+          { error = 3 ; goto quit ; }
+
+     if (get_name (path, &name, &arn) != 0)
+          { error = 3 ; goto quit ; }
+
+     if (draw_dpm (sto.mds, sto.dpm, name, &arn))
+          error = 4 ;
+
+     quit :
+
+     free_arn (&arn) ;
+     shut_sto (&sto) ;
+
+     return error ;
+}
@@ -0,0 +1,124 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef SERVE_H
+# define SERVE_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <errno.h>
+# include <limits.h>
+# include <signal.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/uio.h>
+# include <sys/un.h>
+
+# include "type.h"
+# include "arena.h"
+# include "parse.h"
+# include "draw.h"
+# include "scan.h"
+# include "log.h"
+# include "store.h"
+
+// request line length, hash buckets, cache size in megabytes when none is given
+//  and most samples sent in one window
+
+# define SRV_LINE 4096
+# define SRV_TAB 4096
+# define SRV_CAP 1024
+# define SRV_WIN 65536
+
+// analyzed dump kept in memory, its buffers in an arena of its own
+
+typedef struct ent
+{
+     char *path ;
+     unsigned long hash ;
+     struct timespec mtim ;
+     off_t size ;
+     ARN arn ;
+     MDS mds ;
+     DPM *dpm ;
+     DSC dsc ;
+     SPK *spk ;
+     char *sum ;
+     size_t sum_len ;
+     char *spk_txt ;
+     size_t spk_len ;
+     void *bmp ;
+     size_t bmp_len ;
+     STO sto ;
+     size_t cost ;
+     unsigned int ref ;
+     bool gone ;
+     struct ent *next ;
+     struct ent *newer ;
+     struct ent *older ;
+}
+ENT ;
+
+// entries by path and from the most to the least recently used
+
+typedef struct lru
+{
+     ENT *tab[SRV_TAB] ;
+     ENT *head ;
+     ENT *tail ;
+     size_t used ;
+     size_t cap ;
+     OPT *opt ;
+     int fd ;
+     unsigned int live ;
+     pthread_mutex_t lock ;
+     pthread_mutex_t draw ;
+     pthread_mutex_t seal ;
+     pthread_cond_t idle ;
+}
+LRU ;
+
+typedef struct con
+{
+     LRU *lru ;
+     int fd ;
+}
+CON ;
+
+static unsigned long hash_path (char *path) ;
+static void free_ent (ENT *ent) ;
+static ENT *load_ent (char *path, struct stat *info, OPT *opt, char **text) ;
+static void drop_ent (LRU *lru, ENT *ent) ;
+static void lift_ent (LRU *lru, ENT *ent) ;
+static ENT *take_ent (LRU *lru, char *path, char **text) ;
+static void give_ent (LRU *lru, ENT *ent) ;
+static int send_ans (int fd, void *body, size_t len) ;
+static int send_err (int fd, char *text) ;
+static int answer (LRU *lru, int fd, char *line) ;
+static void *talk_srv (void *arg) ;
+static void *work_srv (void *arg) ;
+
+int serve (char *path, OPT *opt) ;
+int view (char *sock, char *path, OPT *opt) ;
+
+# endif
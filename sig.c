@@ -0,0 +1,254 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "sig.h"
+
+static const char magic[8] = "DPMSIG01" ;
+
+// fixed length signatures of dumps, stored one after another
+//  in a library file, so a query is one pass over contiguous vectors
+
+KERNEL static float calc_dst (const float *a, const float *b)
+{
+     float sum = 0 ;
+
+     for (int i = 0 ; i < SIG_LEN ; i++)
+     {
+          float dif = a[i] - b[i] ;
+          sum += dif * dif ;
+     }
+
+     return sum ;
+}
+
+static void *load_lib (char *path, size_t *size)
+{
+     # if LINUX
+
+     int fd = open (path, O_RDONLY) ;
+     if (fd < 0)
+          return NULL ;
+
+     struct stat st ;
+     void *base = NULL ;
+
+     if (fstat (fd, &st) == 0 && st.st_size > 0)
+     {
+          base = mmap (NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0) ;
+          if (base == MAP_FAILED)
+               base = NULL ;
+          else
+               madvise (base, st.st_size, MADV_SEQUENTIAL) ;
+     }
+
+     close (fd) ;
+
+     *size = st.st_size ;
+
+     return base ;
+
+     # else
+
+     FILE *file = fopen (path, "rb") ;
+     if (file == NULL)
+          return NULL ;
+
+     fseek (file, 0, SEEK_END) ;
+     *size = ftell (file) ;
+     fseek (file, 0, SEEK_SET) ;
+
+     void *base = malloc (*size) ;
+     if (base != NULL && fread (base, 1, *size, file) != *size)
+          { free (base) ; base = NULL ; }
+
+     fclose (file) ;
+
+     return base ;
+
+     # endif
+}
+
+static void free_lib (void *base, size_t size)
+{
+     # if LINUX
+     munmap (base, size) ;
+     # else
+     free (base) ;
+     # endif
+}
+
+int make_sig (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, SIG *sig)
+{
+     memset (sig->vec, 0, sizeof (sig->vec)) ;
+
+     unsigned long len = (unsigned long) mds->smp * mds->itv ;
+     if (mds->sct < len)
+          len = mds->sct ;
+
+     if (mds->smp < SIG_CRV || len == 0)
+          return 1 ;
+
+     // timing curve cut into cells, as a deviation from its mean
+     //  so dumps of one disc read at other speeds stay close
+
+     float avg = 0 ;
+
+     for (int i = 0 ; i < mds->smp ; i++)
+          avg += dpm[i].tim ;
+
+     avg /= mds->smp ;
+
+     if (avg == 0)
+          return 1 ;
+
+     for (int c = 0 ; c < SIG_CRV ; c++)
+     {
+          unsigned int stt = (unsigned long) c * mds->smp / SIG_CRV ;
+          unsigned int stp = (unsigned long) (c + 1) * mds->smp / SIG_CRV ;
+
+          float sum = 0 ;
+
+          for (unsigned int i = stt ; i < stp ; i++)
+               sum += dpm[i].tim ;
+
+          sig->vec[c] = 10 * (sum / (stp - stt) / avg - 1) ;
+     }
+
+     // region bounds as fractions of the disc
+
+     float *reg = sig->vec + SIG_CRV ;
+
+     for (int i = 0 ; i < SIG_REG && i < dsc->stt_cnt && i < dsc->stp_cnt ; i++)
+     {
+          reg[2*i] = (float) dsc->stt_lba[i] / len ;
+          reg[2*i+1] = (float) dsc->stp_lba[i] / len ;
+     }
+
+     // spike lengths in thousands of sectors, known for regular layouts only
+
+     float *len_spk = sig->vec + SIG_CRV + 2 * SIG_REG ;
+
+     if (spk != NULL && dsc->dpm_cat == 0)
+     {
+          unsigned char spr_cnt = dsc->dec_cnt / dsc->stp_cnt ;
+
+          for (int i = 0 ; i < SIG_SPK && i < spr_cnt ; i++)
+          {
+               len_spk[2*i] = spk[i].avg / 1000 ;
+               len_spk[2*i+1] = spk[i].dev / 1000 ;
+          }
+     }
+
+     return 0 ;
+}
+
+int add_sig (char *path, SIG *sig)
+{
+     FILE *file = fopen (path, "ab") ;
+     if (file == NULL)
+          return 1 ;
+
+     int error = 0 ;
+
+     char head[SIG_HEAD] = {0} ;
+     memcpy (head, magic, sizeof (magic)) ;
+
+     // several runs may add to the same library, the size is read once
+     //  the lock is held and the record written before it is released
+
+     # if LINUX
+     if (flock (fileno (file), LOCK_EX) != 0)
+          { fclose (file) ; return 1 ; }
+     # endif
+
+     if (fseek (file, 0, SEEK_END) != 0)
+          error = 2 ;
+     else if (ftell (file) == 0 && fwrite (head, SIG_HEAD, 1, file) != 1)
+          error = 2 ;
+     else if (fwrite (sig, sizeof (SIG), 1, file) != 1)
+          error = 2 ;
+
+     if (fflush (file) != 0)
+          error = 2 ;
+
+     # if LINUX
+     flock (fileno (file), LOCK_UN) ;
+     # endif
+
+     if (fclose (file) != 0)
+          error = 2 ;
+
+     return error ;
+}
+
+int find_sig (char *path, SIG *sig, unsigned int top)
+{
+     size_t size = 0 ;
+
+     void *base = load_lib (path, &size) ;
+     if (base == NULL)
+          return 1 ;
+
+     if (size < SIG_HEAD || memcmp (base, magic, sizeof (magic)) != 0)
+          { free_lib (base, size) ; return 2 ; }
+
+     SIG *lib = (SIG *) ((char *) base + SIG_HEAD) ;
+     size_t cnt = (size - SIG_HEAD) / sizeof (SIG) ;
+
+     if (top == 0)
+          top = 5 ;
+     if (top > SIG_TOP)
+          top = SIG_TOP ;
+
+     // best matches kept sorted, a new one is inserted from the end
+
+     float best_dst[SIG_TOP] ;
+     size_t best_num[SIG_TOP] ;
+     unsigned int found = 0 ;
+
+     for (size_t i = 0 ; i < cnt ; i++)
+     {
+          float dst = calc_dst (sig->vec, lib[i].vec) ;
+
+          if (found == top && dst >= best_dst[top-1])
+               continue ;
+
+          unsigned int k = found < top ? found++ : top - 1 ;
+
+          for ( ; k > 0 && best_dst[k-1] > dst ; k--)
+          {
+               best_dst[k] = best_dst[k-1] ;
+               best_num[k] = best_num[k-1] ;
+          }
+
+          best_dst[k] = dst ;
+          best_num[k] = i ;
+     }
+
+     for (unsigned int k = 0 ; k < found ; k++)
+     {
+          SIG *ref = &lib[best_num[k]] ;
+
+          printf ("%d\t%.4f\t%.64s\t%.64s\n", k+1, sqrtf (best_dst[k]), ref->tag, ref->ref) ;
+     }
+
+     free_lib (base, size) ;
+
+     return 0 ;
+}
@@ -0,0 +1,67 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef SIG_H
+# define SIG_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# if LINUX
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <sys/file.h>
+# endif
+
+# include "type.h"
+
+// signature layout : timing curve cells, region bounds, spike lengths
+
+# define SIG_CRV 48
+# define SIG_REG 4
+# define SIG_SPK 4
+# define SIG_LEN (SIG_CRV + 2 * SIG_REG + 2 * SIG_SPK)
+
+# define SIG_TOP 64
+
+// library header, keeps the vectors on cache line boundaries
+
+# define SIG_HEAD 64
+
+typedef struct sig
+{
+     char tag[64] ;
+     char ref[64] ;
+     float vec[SIG_LEN] ;
+}
+SIG ;
+
+KERNEL static float calc_dst (const float *a, const float *b) ;
+static void *load_lib (char *path, size_t *size) ;
+static void free_lib (void *base, size_t size) ;
+
+int make_sig (MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, SIG *sig) ;
+int add_sig (char *path, SIG *sig) ;
+int find_sig (char *path, SIG *sig, unsigned int top) ;
+
+# endif
@@ -0,0 +1,103 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "skim.h"
+
+// preview of a large file from a strided subset of its samples,
+//  printed and rendered without reading the whole measure
+
+static int show_skm (MDS *mds, DSC *dsc, unsigned int step)
+{
+     printf ("Preview    \t 1 sample out of %d\n\n", step) ;
+
+     if (mds->lay == 2)
+     {
+          printf ("Timing     \t %d / %d\n", dsc->lay_0_avg, dsc->lay_1_avg) ;
+          printf ("Break      \t LBA ~ %ld\n\n", dsc->brk_lba) ;
+     }
+     else printf ("Timing     \t %d\n\n", dsc->tim_avg) ;
+
+     printf ("Segment    \t %d regions\n", dsc->seg_cnt) ;
+
+     for (int i = 0 ; i < dsc->seg_cnt ; i++)
+          printf ("           \t LBA ~ [%ld - %ld]\n", dsc->seg_stt[i], dsc->seg_stp[i]) ;
+
+     if (dsc->seg_cut != 0)
+          printf ("           \t %d more left out\n", dsc->seg_cut) ;
+
+     printf ("\n") ;
+
+     fflush (stdout) ;
+
+     return 0 ;
+}
+
+int skim (FILE *file, MDS *mds, char *name, OPT *opt)
+{
+     unsigned int step = (mds->smp + SKM_PTS - 1) / SKM_PTS ;
+
+     // small files are read whole at once
+
+     if (step < 2)
+          return 1 ;
+
+     // coarse samples stand for as many sectors as they average
+
+     MDS pre = *mds ;
+
+     pre.smp = mds->smp / step ;
+     pre.itv = mds->itv * step ;
+
+     ARN arn = {0} ;
+     DSC dsc = {0} ;
+
+     int error = 0 ;
+
+     if (make_arn (&arn, size_arn (&pre, opt, name), false) != 0)
+          { error = 2 ; goto quit ; }
+
+     DPM *dpm = make_dpm (&arn, pre.smp) ;
+     if (dpm == NULL)
+          { error = 2 ; goto quit ; }
+
+     skim_dpm (file, mds, dpm, step) ;
+
+     if (eval_pre (&pre, dpm, &dsc, mds->itv, &arn) != 0)
+          { error = 3 ; goto quit ; }
+
+     show_skm (&pre, &dsc, step) ;
+
+     // picture named after the file with a .pre.bmp extension
+
+     char *name_pre = take_arn (&arn, strlen (name) + 5) ;
+     if (name_pre == NULL)
+          { error = 2 ; goto quit ; }
+
+     strcpy (name_pre, name) ;
+     strcat (name_pre, ".pre") ;
+
+     if (save_bmp (&pre, dpm, name_pre, &arn))
+          { error = 4 ; goto quit ; }
+
+     quit :
+
+     free_arn (&arn) ;
+
+     return error ;
+}
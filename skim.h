@@ -0,0 +1,41 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef SKIM_H
+# define SKIM_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+
+# include "type.h"
+# include "arena.h"
+# include "parse.h"
+# include "scan.h"
+# include "draw.h"
+
+// number of samples read for a preview
+
+# define SKM_PTS 1024
+
+static int show_skm (MDS *mds, DSC *dsc, unsigned int step) ;
+
+int skim (FILE *file, MDS *mds, char *name, OPT *opt) ;
+
+# endif
@@ -0,0 +1,287 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "split.h"
+
+// density regions located on the timing curve itself,
+//  cut into segments of constant mean by pruned exact linear time
+//  change point detection, then kept where a segment stands above
+//  its neighbours and grouped like spikes in seek_reg
+
+static double seek_dev (DPM *dpm, int smp_stt, int smp_stp)
+{
+     // timing noise variance from the median absolute variation,
+     //  variations being the difference of two noisy timings
+
+     unsigned int cnt[256] = {0} ;
+     unsigned int num = smp_stp - smp_stt + 1 ;
+
+     for (int i = smp_stt ; i <= smp_stp ; i++)
+     {
+          unsigned int var = abs (dpm[i].var) ;
+          cnt[var < 255 ? var : 255] += 1 ;
+     }
+
+     unsigned int med = 0 ;
+     unsigned int low = 0 ;
+
+     while (low + cnt[med] <= num / 2)
+          low += cnt[med++] ;
+
+     double dev = 1.4826 * (med > 0 ? med : 0.5) ;
+
+     return dev * dev / 2 ;
+}
+
+static double calc_cst (SPL *spl, unsigned int stt, unsigned int stp)
+{
+     // squared error of samples stt to stp - 1 around their mean, from exact
+     //  integer sums so that a sample far off such as the end of a truncated
+     //  file does not drown the others in rounding
+
+     unsigned int num = stp - stt ;
+     signed long sum = spl->sum[stp] - spl->sum[stt] ;
+     __int128 sqr = spl->sqr[stp] - spl->sqr[stt] ;
+
+     return (double) (sqr * num - (__int128) sum * sum) / num ;
+}
+
+static unsigned int part_tim (SPL *spl, DPM *dpm, int smp_stt, int smp_stp, double pen)
+{
+     unsigned int num = smp_stp - smp_stt + 1 ;
+
+     // prefix sums of timings centered on the first one
+
+     spl->sum[0] = 0 ;
+     spl->sqr[0] = 0 ;
+
+     for (unsigned int i = 0 ; i < num ; i++)
+     {
+          signed long tim = (signed long) dpm[smp_stt+i].tim - dpm[smp_stt].tim ;
+
+          spl->sum[i+1] = spl->sum[i] + tim ;
+          spl->sqr[i+1] = spl->sqr[i] + (__int128) tim * tim ;
+     }
+
+     // best cost of the first t samples and its last change point,
+     //  candidates that can no longer start the last segment are pruned
+
+     unsigned int cnd_cnt = 1 ;
+
+     spl->cst[0] = - pen ;
+     spl->cnd[0] = 0 ;
+
+     for (unsigned int t = 1 ; t <= num ; t++)
+     {
+          double best = INFINITY ;
+          unsigned int last = 0 ;
+
+          for (unsigned int k = 0 ; k < cnd_cnt ; k++)
+          {
+               unsigned int s = spl->cnd[k] ;
+               double cst = spl->cst[s] + calc_cst (spl, s, t) ;
+
+               spl->val[k] = cst ;
+
+               if (cst < best)
+                    { best = cst ; last = s ; }
+          }
+
+          spl->cst[t] = best + pen ;
+          spl->lst[t] = last ;
+
+          // a candidate no better than the best without the penalty of
+          //  a new change point can never become the best again, ties
+          //  included as on a flat stretch where every cost is the same
+
+          double lim = best + pen * (1 - SPL_TOL) ;
+          unsigned int keep = 0 ;
+
+          for (unsigned int k = 0 ; k < cnd_cnt ; k++)
+          {
+               if (spl->val[k] < lim)
+                    spl->cnd[keep++] = spl->cnd[k] ;
+          }
+
+          spl->cnd[keep++] = t ;
+          cnd_cnt = keep ;
+     }
+
+     // segment bounds from the last sample back to the first,
+     //  then stored in order, the candidates are no longer needed
+
+     unsigned int cnt = 0 ;
+
+     for (unsigned int t = num ; t > 0 ; t = spl->lst[t])
+          spl->cnd[cnt++] = t ;
+
+     for (unsigned int i = 0 ; i < cnt / 2 ; i++)
+     {
+          unsigned int tmp = spl->cnd[i] ;
+          spl->cnd[i] = spl->cnd[cnt-1-i] ;
+          spl->cnd[cnt-1-i] = tmp ;
+     }
+
+     return cnt ;
+}
+
+static int seek_seg (MDS *mds, DSC *dsc, SPL *spl, int smp_stt, unsigned int cnt, unsigned int itv)
+{
+     unsigned int threshold = 0 ;
+
+     if (mds->cd)
+          threshold = 4000 ;
+     else if (mds->dvd)
+          threshold = 40000 ;
+
+     // smallest step of a region, as for a spike at the measured interval
+
+     double step = 100 ;
+
+     switch (itv)
+     {
+          case 50 :
+               step = 13 ;
+               break ;
+          case 256 :
+               step = 10 ;
+               break ;
+     }
+
+     // a step shorter than an averaged sample is spread over all of it
+
+     step = step * itv / mds->itv ;
+
+     unsigned long prv_lba = 0 ;
+     bool open = false ;
+     bool kept = false ;
+
+     for (unsigned int k = 0 ; k < cnt ; k++)
+     {
+          unsigned int stt = k > 0 ? spl->cnd[k-1] : 0 ;
+          unsigned int stp = spl->cnd[k] ;
+
+          double avg = (double) (spl->sum[stp] - spl->sum[stt]) / (stp - stt) ;
+
+          bool high = cnt > 1 ;
+
+          if (k > 0)
+          {
+               unsigned int bef = k > 1 ? spl->cnd[k-2] : 0 ;
+               high &= avg - (double) (spl->sum[stt] - spl->sum[bef]) / (stt - bef) > step ;
+          }
+
+          if (k < cnt - 1)
+          {
+               unsigned int aft = spl->cnd[k+1] ;
+               high &= avg - (double) (spl->sum[aft] - spl->sum[stp]) / (aft - stp) > step ;
+          }
+
+          if (! high || stp - stt < SPL_MIN)
+               continue ;
+
+          // same sectors as the increase and decrease spikes around the segment
+
+          unsigned long stt_lba = (unsigned long) (smp_stt + stt + 1) * mds->itv ;
+          unsigned long stp_lba = (unsigned long) (smp_stt + stp + 1) * mds->itv ;
+
+          if (open && stt_lba - prv_lba <= threshold)
+          {
+               if (kept)
+                    dsc->seg_stp[dsc->seg_cnt-1] = stp_lba ;
+          }
+          else if (dsc->seg_cnt == 10)
+          {
+               // further regions are counted and reported as left out
+
+               if (dsc->seg_cut < 255)
+                    dsc->seg_cut += 1 ;
+               kept = false ;
+          }
+          else
+          {
+               dsc->seg_stt[dsc->seg_cnt] = stt_lba ;
+               dsc->seg_stp[dsc->seg_cnt] = stp_lba ;
+               dsc->seg_cnt += 1 ;
+               kept = true ;
+          }
+
+          prv_lba = stt_lba ;
+          open = true ;
+     }
+
+     return dsc->seg_cut != 0 ;
+}
+
+size_t size_spl (MDS *mds)
+{
+     size_t sum = (mds->smp + 1) * sizeof (signed long) + ARN_ALIGN ;
+     size_t sqr = (mds->smp + 1) * sizeof (__int128) + ARN_ALIGN ;
+     size_t real = (mds->smp + 1) * sizeof (double) + ARN_ALIGN ;
+     size_t index = (mds->smp + 1) * sizeof (unsigned int) + ARN_ALIGN ;
+
+     return sum + sqr + 2 * real + 2 * index ;
+}
+
+int split_dpm (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn)
+{
+     SPL spl = {0} ;
+
+     spl.sum = take_arn (arn, (mds->smp + 1) * sizeof (signed long)) ;
+     spl.sqr = take_arn (arn, (mds->smp + 1) * sizeof (__int128)) ;
+     spl.cst = take_arn (arn, (mds->smp + 1) * sizeof (double)) ;
+     spl.val = take_arn (arn, (mds->smp + 1) * sizeof (double)) ;
+     spl.lst = take_arn (arn, (mds->smp + 1) * sizeof (unsigned int)) ;
+     spl.cnd = take_arn (arn, (mds->smp + 1) * sizeof (unsigned int)) ;
+
+     if (spl.sum == NULL || spl.sqr == NULL || spl.cst == NULL || spl.val == NULL || spl.lst == NULL || spl.cnd == NULL)
+          return 2 ;
+
+     // each layer is cut on its own, the break being a change of its own
+
+     int smp_stt[2] = {0, 0} ;
+     int smp_stp[2] = {mds->smp - 1, 0} ;
+     int lay_cnt = 1 ;
+
+     if (mds->lay == 2 && mds->itv != 50)
+     {
+          smp_stp[0] = dsc->brk_smp ;
+          smp_stt[1] = dsc->brk_smp + 1 ;
+          smp_stp[1] = mds->smp - 1 ;
+          lay_cnt = 2 ;
+     }
+
+     int state = 0 ;
+
+     for (int l = 0 ; l < lay_cnt ; l++)
+     {
+          if (smp_stp[l] <= smp_stt[l])
+               continue ;
+
+          // penalty of a change point grows with the noise and the sample count
+
+          double pen = 3 * seek_dev (dpm, smp_stt[l], smp_stp[l]) * log (smp_stp[l] - smp_stt[l] + 1) ;
+
+          unsigned int cnt = part_tim (&spl, dpm, smp_stt[l], smp_stp[l], pen) ;
+
+          state |= seek_seg (mds, dsc, &spl, smp_stt[l], cnt, itv) ;
+     }
+
+     return state ;
+}
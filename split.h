@@ -0,0 +1,58 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef SPLIT_H
+# define SPLIT_H
+
+# include <stdlib.h>
+# include <math.h>
+
+# include "type.h"
+# include "arena.h"
+
+// samples of the shortest spike, a lone sample above its neighbours
+//  being a glitch rather than a region
+
+# define SPL_MIN 2
+
+// share of the penalty by which a candidate must beat the best to be kept,
+//  so that ties and rounding prune it instead of keeping it forever
+
+# define SPL_TOL 1e-9
+
+typedef struct spl
+{
+     signed long *sum ;
+     __int128 *sqr ;
+     double *cst ;
+     double *val ;
+     unsigned int *lst ;
+     unsigned int *cnd ;
+}
+SPL ;
+
+static double seek_dev (DPM *dpm, int smp_stt, int smp_stp) ;
+static double calc_cst (SPL *spl, unsigned int stt, unsigned int stp) ;
+static unsigned int part_tim (SPL *spl, DPM *dpm, int smp_stt, int smp_stp, double pen) ;
+static int seek_seg (MDS *mds, DSC *dsc, SPL *spl, int smp_stt, unsigned int cnt, unsigned int itv) ;
+
+size_t size_spl (MDS *mds) ;
+int split_dpm (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn) ;
+
+# endif
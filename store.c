@@ -0,0 +1,278 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+// memfd_create and the file seals
+
+# define _GNU_SOURCE
+
+# include "store.h"
+
+// a dump parsed and analyzed once, then read in place by any number of processes :
+//  clients asking the server for it such as the charts of scan -y, or other
+//  tools given the descriptor or a path to it such as /proc/pid/fd/n
+
+static size_t form_sto (STH *sth, MDS *mds, unsigned int spk_cnt)
+{
+     // the sizes of the structures tell builds with another layout apart
+
+     memcpy (sth->magic, STO_MAGIC, 8) ;
+
+     sth->version = STO_VERSION ;
+     sth->mds_size = sizeof (MDS) ;
+     sth->dpm_size = sizeof (DPM) ;
+     sth->dsc_size = sizeof (DSC) ;
+     sth->spk_size = sizeof (SPK) ;
+     sth->spk_cnt = spk_cnt ;
+
+     size_t dpm_len = (size_t) (mds->smp + 2 * DPM_PAD) * sizeof (DPM) ;
+
+     sth->dpm_off = (sizeof (STH) + ARN_ALIGN - 1) / ARN_ALIGN * ARN_ALIGN ;
+     sth->dsc_off = (sth->dpm_off + dpm_len + ARN_ALIGN - 1) / ARN_ALIGN * ARN_ALIGN ;
+     sth->spk_off = (sth->dsc_off + sizeof (DSC) + ARN_ALIGN - 1) / ARN_ALIGN * ARN_ALIGN ;
+     sth->size = sth->spk_off + spk_cnt * sizeof (SPK) ;
+
+     sth->mds = *mds ;
+
+     return sth->size ;
+}
+
+static int load_sto (STO *sto)
+{
+     STH *sth = (STH *) sto->base ;
+     STH ref = {0} ;
+
+     if (memcmp (sth->magic, STO_MAGIC, 8) != 0 || sth->version != STO_VERSION)
+          return 1 ;
+
+     // laid out as this build would have done it, up to the last byte
+
+     if (sth->spk_cnt > 200 || form_sto (&ref, &sth->mds, sth->spk_cnt) != sto->size)
+          return 2 ;
+     if (memcmp (&ref, sth, offsetof (STH, mds)) != 0)
+          return 2 ;
+
+     sto->mds = &sth->mds ;
+     sto->dpm = (DPM *) (sto->base + sth->dpm_off) + DPM_PAD ;
+     sto->dsc = (DSC *) (sto->base + sth->dsc_off) ;
+     sto->spk = sth->spk_cnt > 0 ? (SPK *) (sto->base + sth->spk_off) : NULL ;
+
+     return 0 ;
+}
+
+int make_sto (STO *sto, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name)
+{
+     STH sth = {0} ;
+     unsigned char *base = MAP_FAILED ;
+     char label[64] ;
+
+     int error = 0 ;
+
+     memset (sto, 0, sizeof (STO)) ;
+
+     // spike lengths are known for regular layouts only
+
+     unsigned int spk_cnt = spk != NULL && dsc->dpm_cat == 0 ? dsc->dec_cnt / dsc->stp_cnt : 0 ;
+     size_t size = form_sto (&sth, mds, spk_cnt) ;
+
+     snprintf (label, sizeof (label), "dpmscn %s", name) ;
+
+     int fd = memfd_create (label, MFD_CLOEXEC | MFD_ALLOW_SEALING) ;
+     if (fd < 0)
+          return 1 ;
+
+     if (ftruncate (fd, size) != 0)
+          { error = 2 ; goto quit ; }
+
+     base = mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0) ;
+     if (base == MAP_FAILED)
+          { error = 2 ; goto quit ; }
+
+     memcpy (base, &sth, sizeof (STH)) ;
+     memcpy (base + sth.dpm_off, dpm - DPM_PAD, (size_t) (mds->smp + 2 * DPM_PAD) * sizeof (DPM)) ;
+     memcpy (base + sth.dsc_off, dsc, sizeof (DSC)) ;
+
+     if (spk_cnt > 0)
+          memcpy (base + sth.spk_off, spk, spk_cnt * sizeof (SPK)) ;
+
+     // no writable mapping may be left when sealing, readers then
+     //  rely on the contents and the size for as long as they hold it
+
+     munmap (base, size) ;
+
+     if (fcntl (fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) != 0)
+          { error = 3 ; goto quit ; }
+
+     error = open_sto (sto, fd) != 0 ? 4 : 0 ;
+     fd = -1 ;
+
+     quit :
+
+     if (fd >= 0)
+          close (fd) ;
+
+     return error ;
+}
+
+int open_sto (STO *sto, int fd)
+{
+     // the descriptor belongs to the store from now on, closed on failure
+
+     struct stat info = {0} ;
+
+     memset (sto, 0, sizeof (STO)) ;
+
+     int seals = fcntl (fd, F_GET_SEALS) ;
+
+     if (seals < 0 || (seals & (F_SEAL_WRITE | F_SEAL_SHRINK)) != (F_SEAL_WRITE | F_SEAL_SHRINK))
+          { close (fd) ; return 1 ; }
+
+     if (fstat (fd, &info) != 0 || info.st_size < sizeof (STH))
+          { close (fd) ; return 2 ; }
+
+     void *base = mmap (NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0) ;
+     if (base == MAP_FAILED)
+          { close (fd) ; return 2 ; }
+
+     sto->fd = fd ;
+     sto->base = base ;
+     sto->size = info.st_size ;
+
+     if (load_sto (sto) != 0)
+          { shut_sto (sto) ; return 3 ; }
+
+     return 0 ;
+}
+
+int find_sto (STO *sto, char *path)
+{
+     int fd = open (path, O_RDONLY | O_CLOEXEC) ;
+     if (fd < 0)
+          return 1 ;
+
+     return open_sto (sto, fd) ;
+}
+
+int pass_sto (int con, int fd, char *head)
+{
+     // the descriptor rides beside a short header, a reader gone
+     //  meanwhile being an error and not a signal
+
+     union { struct cmsghdr align ; char buf[CMSG_SPACE (sizeof (int))] ; } ctl ;
+     struct iovec part = {head, strlen (head)} ;
+     struct msghdr msg = {0} ;
+
+     memset (&ctl, 0, sizeof (ctl)) ;
+
+     msg.msg_iov = &part ;
+     msg.msg_iovlen = 1 ;
+     msg.msg_control = ctl.buf ;
+     msg.msg_controllen = sizeof (ctl.buf) ;
+
+     struct cmsghdr *cmsg = CMSG_FIRSTHDR (&msg) ;
+
+     cmsg->cmsg_level = SOL_SOCKET ;
+     cmsg->cmsg_type = SCM_RIGHTS ;
+     cmsg->cmsg_len = CMSG_LEN (sizeof (int)) ;
+     memcpy (CMSG_DATA (cmsg), &fd, sizeof (int)) ;
+
+     ssize_t done = 0 ;
+
+     do done = sendmsg (con, &msg, MSG_NOSIGNAL) ;
+     while (done < 0 && errno == EINTR) ;
+
+     return done != strlen (head) ;
+}
+
+int take_sto (STO *sto, int con, int flags, char *head, size_t size)
+{
+     // 0 attached, 1 nothing sent yet, 2 closed or sent without a descriptor,
+     //  3 a descriptor that is not a valid store
+
+     union { struct cmsghdr align ; char buf[CMSG_SPACE (sizeof (int))] ; } ctl ;
+     struct iovec part = {head, size - 1} ;
+     struct msghdr msg = {0} ;
+
+     memset (head, 0, size) ;
+
+     msg.msg_iov = &part ;
+     msg.msg_iovlen = 1 ;
+     msg.msg_control = ctl.buf ;
+     msg.msg_controllen = sizeof (ctl.buf) ;
+
+     ssize_t len = 0 ;
+
+     do len = recvmsg (con, &msg, MSG_CMSG_CLOEXEC | flags) ;
+     while (len < 0 && errno == EINTR) ;
+
+     if (len < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+          return 1 ;
+
+     int fd = -1 ;
+     struct cmsghdr *cmsg = len > 0 ? CMSG_FIRSTHDR (&msg) : NULL ;
+
+     if (cmsg != NULL && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS)
+          memcpy (&fd, CMSG_DATA (cmsg), sizeof (int)) ;
+
+     if (fd < 0)
+          return 2 ;
+
+     return open_sto (sto, fd) != 0 ? 3 : 0 ;
+}
+
+int join_sto (STO *sto, char *sock, char *path)
+{
+     struct sockaddr_un addr = {0} ;
+
+     if (strlen (sock) >= sizeof (addr.sun_path))
+          return 1 ;
+
+     addr.sun_family = AF_UNIX ;
+     strcpy (addr.sun_path, sock) ;
+
+     int con = socket (AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0) ;
+     if (con < 0)
+          return 1 ;
+
+     if (connect (con, (struct sockaddr *) &addr, sizeof (addr)) != 0 || dprintf (con, "MFD %s\n", path) < 0)
+          { close (con) ; return 1 ; }
+
+     // the answer header carries the descriptor, an error line comes alone
+
+     char head[256] ;
+
+     int state = take_sto (sto, con, 0, head, sizeof (head)) ;
+
+     close (con) ;
+
+     if (state == 0 && strncmp (head, "OK ", 3) != 0)
+          { shut_sto (sto) ; return 2 ; }
+
+     return state == 1 ? 2 : state ;
+}
+
+void shut_sto (STO *sto)
+{
+     if (sto->base != NULL)
+     {
+          munmap (sto->base, sto->size) ;
+          close (sto->fd) ;
+     }
+
+     memset (sto, 0, sizeof (STO)) ;
+}
@@ -0,0 +1,87 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef STORE_H
+# define STORE_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <stddef.h>
+# include <string.h>
+# include <errno.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/socket.h>
+# include <sys/stat.h>
+# include <sys/un.h>
+
+# include "type.h"
+# include "arena.h"
+
+// shared sample store, one sealed memory file per dump :
+//  the header, the samples with their guard samples, the analysis
+//  and the spike lengths, each part on its own cache line
+
+# define STO_MAGIC "DPMSTO01"
+# define STO_VERSION 1
+
+typedef struct sth
+{
+     char magic[8] ;
+     unsigned int version ;
+     unsigned int mds_size ;
+     unsigned int dpm_size ;
+     unsigned int dsc_size ;
+     unsigned int spk_size ;
+     unsigned int spk_cnt ;
+     unsigned long dpm_off ;
+     unsigned long dsc_off ;
+     unsigned long spk_off ;
+     unsigned long size ;
+     MDS mds ;
+}
+STH ;
+
+// attached store, read only
+
+typedef struct sto
+{
+     int fd ;
+     unsigned char *base ;
+     size_t size ;
+     MDS *mds ;
+     DPM *dpm ;
+     DSC *dsc ;
+     SPK *spk ;
+}
+STO ;
+
+static size_t form_sto (STH *sth, MDS *mds, unsigned int spk_cnt) ;
+static int load_sto (STO *sto) ;
+
+int make_sto (STO *sto, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk, char *name) ;
+int open_sto (STO *sto, int fd) ;
+int find_sto (STO *sto, char *path) ;
+int pass_sto (int con, int fd, char *head) ;
+int take_sto (STO *sto, int con, int flags, char *head, size_t size) ;
+int join_sto (STO *sto, char *sock, char *path) ;
+void shut_sto (STO *sto) ;
+
+# endif
@@ -0,0 +1,218 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "stream.h"
+
+static size_t fill_src (SRC *src)
+{
+     if (src->in_pos < src->in_len)
+          return src->in_len - src->in_pos ;
+
+     src->in_pos = 0 ;
+     src->in_len = fread (src->in, 1, SRC_BUF, src->file) ;
+
+     return src->in_len ;
+}
+
+static size_t copy_raw (SRC *src, unsigned char *buf, size_t len)
+{
+     size_t done = 0 ;
+
+     while (done < len && fill_src (src) > 0)
+     {
+          size_t part = src->in_len - src->in_pos ;
+          if (part > len - done)
+               part = len - done ;
+
+          if (buf != NULL)
+               memcpy (buf + done, src->in + src->in_pos, part) ;
+
+          src->in_pos += part ;
+          done += part ;
+     }
+
+     return done ;
+}
+
+static size_t copy_gz (SRC *src, unsigned char *buf, size_t len)
+{
+     unsigned char sink[4096] ;
+     size_t done = 0 ;
+
+     while (done < len && ! src->end)
+     {
+          if (fill_src (src) == 0)
+               break ;
+
+          size_t part = len - done ;
+
+          if (buf == NULL && part > sizeof (sink))
+               part = sizeof (sink) ;
+
+          src->gz.next_in = src->in + src->in_pos ;
+          src->gz.avail_in = src->in_len - src->in_pos ;
+          src->gz.next_out = buf != NULL ? buf + done : sink ;
+          src->gz.avail_out = part ;
+
+          int state = inflate (&src->gz, Z_NO_FLUSH) ;
+
+          src->in_pos = src->in_len - src->gz.avail_in ;
+          done += part - src->gz.avail_out ;
+
+          // concatenated archives hold one gzip member per file
+
+          if (state == Z_STREAM_END)
+          {
+               if (fill_src (src) == 0)
+                    src->end = true ;
+               else inflateReset (&src->gz) ;
+          }
+          else if (state != Z_OK && state != Z_BUF_ERROR)
+               src->end = true ;
+     }
+
+     return done ;
+}
+
+# if ZSTD
+
+static size_t copy_zs (SRC *src, unsigned char *buf, size_t len)
+{
+     unsigned char sink[4096] ;
+     size_t done = 0 ;
+
+     while (done < len && ! src->end)
+     {
+          if (fill_src (src) == 0)
+               break ;
+
+          size_t part = len - done ;
+
+          if (buf == NULL && part > sizeof (sink))
+               part = sizeof (sink) ;
+
+          ZSTD_inBuffer zin = {src->in, src->in_len, src->in_pos} ;
+          ZSTD_outBuffer zout = {buf != NULL ? buf + done : sink, part, 0} ;
+
+          size_t state = ZSTD_decompressStream (src->zs, &zout, &zin) ;
+
+          src->in_pos = zin.pos ;
+          done += zout.pos ;
+
+          if (ZSTD_isError (state))
+               src->end = true ;
+     }
+
+     return done ;
+}
+
+# endif
+
+bool test_src (char *path)
+{
+     unsigned int len = strlen (path) ;
+
+     if (strcmp (path, "-") == 0)
+          return true ;
+     if (len > 3 && strcmp (path + len - 3, ".gz") == 0)
+          return true ;
+     if (len > 4 && strcmp (path + len - 4, ".zst") == 0)
+          return true ;
+
+     return false ;
+}
+
+int open_src (char *path, SRC *src)
+{
+     if (strcmp (path, "-") == 0)
+          src->file = stdin ;
+     else src->file = fopen (path, "rb") ;
+
+     if (src->file == NULL)
+          return 1 ;
+
+     // identify the compression from the first bytes instead of the name
+
+     fill_src (src) ;
+
+     unsigned char *magic = src->in ;
+
+     if (src->in_len >= 2 && magic[0] == 0x1F && magic[1] == 0x8B)
+     {
+          if (inflateInit2 (&src->gz, 15 + 32) != Z_OK)
+               return 2 ;
+          src->kind = 'g' ;
+     }
+     else if (src->in_len >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD)
+     {
+          # if ZSTD
+          src->zs = ZSTD_createDStream () ;
+          if (src->zs == NULL)
+               return 2 ;
+          ZSTD_initDStream (src->zs) ;
+          src->kind = 'z' ;
+          # else
+          fprintf (stderr, "Zstandard support not compiled\n") ;
+          return 3 ;
+          # endif
+     }
+     else src->kind = 'r' ;
+
+     return 0 ;
+}
+
+size_t read_src (SRC *src, void *buf, size_t len)
+{
+     switch (src->kind)
+     {
+          case 'r' :
+               return copy_raw (src, buf, len) ;
+          case 'g' :
+               return copy_gz (src, buf, len) ;
+          # if ZSTD
+          case 'z' :
+               return copy_zs (src, buf, len) ;
+          # endif
+     }
+
+     return 0 ;
+}
+
+size_t skip_src (SRC *src, size_t len)
+{
+     return read_src (src, NULL, len) ;
+}
+
+int close_src (SRC *src)
+{
+     if (src->kind == 'g')
+          inflateEnd (&src->gz) ;
+
+     # if ZSTD
+     if (src->zs != NULL)
+          ZSTD_freeDStream (src->zs) ;
+     # endif
+
+     if (src->file != NULL && src->file != stdin)
+          fclose (src->file) ;
+
+     src->file = NULL ;
+
+     return 0 ;
+}
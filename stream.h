@@ -0,0 +1,63 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef STREAM_H
+# define STREAM_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <zlib.h>
+
+# if ZSTD
+# include <zstd.h>
+# endif
+
+# define SRC_BUF 65536
+
+typedef struct src
+{
+     FILE *file ;
+     char kind ;
+     bool end ;
+     z_stream gz ;
+     # if ZSTD
+     ZSTD_DStream *zs ;
+     # endif
+     unsigned char in[SRC_BUF] ;
+     size_t in_pos ;
+     size_t in_len ;
+}
+SRC ;
+
+static size_t fill_src (SRC *src) ;
+static size_t copy_raw (SRC *src, unsigned char *buf, size_t len) ;
+static size_t copy_gz (SRC *src, unsigned char *buf, size_t len) ;
+# if ZSTD
+static size_t copy_zs (SRC *src, unsigned char *buf, size_t len) ;
+# endif
+
+bool test_src (char *path) ;
+int open_src (char *path, SRC *src) ;
+size_t read_src (SRC *src, void *buf, size_t len) ;
+size_t skip_src (SRC *src, size_t len) ;
+int close_src (SRC *src) ;
+
+# endif
@@ -0,0 +1,152 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "svg.h"
+
+// vector copy of the two curve panels of draw_dpm, each curve reduced to the
+//  lowest and highest point of every column so that the size of the file
+//  depends on the width of the chart and not on the samples
+
+static double calc_pos (MDS *mds, unsigned int count, unsigned long sector)
+{
+     // column of a sector as in calc_col, the lower panel being zoomed on the first samples
+
+     return (double) sector * mds->smp * OVL_COL / ((double) count * mds->sct) ;
+}
+
+static int save_crv (FILE *file, SDL_Point *point, int cnt, char *kind)
+{
+     fprintf (file, "<polyline class=\"%s\" points=\"", kind) ;
+
+     // flat columns give the same lowest and highest point
+
+     for (int i = 0 ; i < cnt ; i++)
+     {
+          if (i > 0 && point[i].x == point[i-1].x && point[i].y == point[i-1].y)
+               continue ;
+
+          fprintf (file, "%s%d,%d", i ? " " : "", point[i].x, point[i].y) ;
+     }
+
+     fprintf (file, "\"/>\n") ;
+
+     return 0 ;
+}
+
+static int save_mrk (FILE *file, MDS *mds, DSC *dsc, unsigned int count, int height)
+{
+     // regions shaded first, then increases pointing down from the top,
+     //  decreases pointing up from the bottom and the layer break
+
+     for (int i = 0 ; i < dsc->stt_cnt && i < dsc->stp_cnt ; i++)
+     {
+          double stt = calc_pos (mds, count, dsc->stt_lba[i]) ;
+          double stp = calc_pos (mds, count, dsc->stp_lba[i]) ;
+
+          if (stt >= OVL_COL || stp < stt)
+               continue ;
+
+          fprintf (file, "<rect class=\"reg\" x=\"%.1f\" y=\"0\" width=\"%.1f\" height=\"%d\"><title>Region %d [%ld - %ld]</title></rect>\n",
+                   stt, (stp < OVL_COL ? stp : OVL_COL) - stt, height, i + 1, dsc->stt_lba[i], dsc->stp_lba[i]) ;
+     }
+
+     for (int i = 0 ; i < dsc->inc_cnt ; i++)
+     {
+          double x = calc_pos (mds, count, dsc->inc_lba[i]) ;
+
+          if (x < OVL_COL)
+               fprintf (file, "<path class=\"inc\" d=\"M%.1f,6 l-3,-6 h6 z\"><title>Increase # %d LBA %ld</title></path>\n",
+                        x, i + 1, dsc->inc_lba[i]) ;
+     }
+
+     for (int i = 0 ; i < dsc->dec_cnt ; i++)
+     {
+          double x = calc_pos (mds, count, dsc->dec_lba[i]) ;
+
+          if (x < OVL_COL)
+               fprintf (file, "<path class=\"dec\" d=\"M%.1f,%d l-3,6 h6 z\"><title>Decrease # %d LBA %ld</title></path>\n",
+                        x, height - 6, i + 1, dsc->dec_lba[i]) ;
+     }
+
+     if (mds->lay == 2 && dsc->brk_lba != 0)
+     {
+          double x = calc_pos (mds, count, dsc->brk_lba) ;
+
+          if (x < OVL_COL)
+               fprintf (file, "<line class=\"brk\" x1=\"%.1f\" y1=\"0\" x2=\"%.1f\" y2=\"%d\"><title>Break LBA ~ %ld</title></line>\n",
+                        x, x, height, dsc->brk_lba) ;
+     }
+
+     return 0 ;
+}
+
+static int save_pan (FILE *file, MDS *mds, DSC *dsc, OVL *ovl, int pan, int top, int height)
+{
+     unsigned int count = pan == 0 || mds->smp < 750 ? mds->smp : 750 ;
+
+     // frame drawn around the panel, everything inside is clipped to it
+
+     fprintf (file, "<rect class=\"frm\" x=\"9.5\" y=\"%.1f\" width=\"641\" height=\"%d\"/>\n", top - 0.5, height + 1) ;
+     fprintf (file, "<svg x=\"10\" y=\"%d\" width=\"640\" height=\"%d\" viewBox=\"0 0 640 %d\">\n", top, height, height) ;
+     fprintf (file, "<rect class=\"bkg\" width=\"640\" height=\"%d\"/>\n", height) ;
+
+     save_mrk (file, mds, dsc, count, height) ;
+     save_crv (file, ovl->tim[pan], ovl->cnt[pan], "tim") ;
+     save_crv (file, ovl->var[pan], ovl->cnt[pan], "var") ;
+
+     fprintf (file, "</svg>\n") ;
+
+     return 0 ;
+}
+
+int save_svg (FILE *file, MDS *mds, DPM *dpm, DSC *dsc)
+{
+     if (mds->smp == 0 || mds->sct == 0)
+          return 1 ;
+
+     OVL *ovl = calloc (1, sizeof (OVL)) ;
+     if (ovl == NULL)
+          return 2 ;
+
+     make_ovl (mds, dpm, ovl) ;
+
+     // classes let reports restyle or annotate the chart
+
+     fprintf (file, "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"660\" height=\"720\" viewBox=\"0 0 660 720\">\n") ;
+     fprintf (file, "<style>\n") ;
+     fprintf (file, "svg { background : #373737 }\n") ;
+     fprintf (file, ".frm { fill : none ; stroke : #232323 }\n") ;
+     fprintf (file, ".bkg { fill : #000000 }\n") ;
+     fprintf (file, ".tim { fill : none ; stroke : #ff0000 }\n") ;
+     fprintf (file, ".var { fill : none ; stroke : #0000ff }\n") ;
+     fprintf (file, ".reg { fill : #ffffff ; fill-opacity : 0.08 }\n") ;
+     fprintf (file, ".inc { fill : #ffaa00 }\n") ;
+     fprintf (file, ".dec { fill : #00c8ff }\n") ;
+     fprintf (file, ".brk { stroke : #ffffff ; stroke-dasharray : 4 3 }\n") ;
+     fprintf (file, "</style>\n") ;
+
+     save_pan (file, mds, dsc, ovl, 0, 10, 440) ;
+     save_pan (file, mds, dsc, ovl, 1, 460, 250) ;
+
+     fprintf (file, "</svg>\n") ;
+
+     free (ovl) ;
+
+     return 0 ;
+}
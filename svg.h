@@ -0,0 +1,36 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef SVG_H
+# define SVG_H
+
+# include <stdio.h>
+# include <stdlib.h>
+
+# include "type.h"
+# include "draw.h"
+
+static double calc_pos (MDS *mds, unsigned int count, unsigned long sector) ;
+static int save_crv (FILE *file, SDL_Point *point, int cnt, char *kind) ;
+static int save_mrk (FILE *file, MDS *mds, DSC *dsc, unsigned int count, int height) ;
+static int save_pan (FILE *file, MDS *mds, DSC *dsc, OVL *ovl, int pan, int top, int height) ;
+
+int save_svg (FILE *file, MDS *mds, DPM *dpm, DSC *dsc) ;
+
+# endif
@@ -0,0 +1,224 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "triage.h"
+
+static int add_path (char ***list, unsigned int *cnt, unsigned int *max, char *path)
+{
+     if (*cnt == *max)
+     {
+          unsigned int len = *max ? *max * 2 : 64 ;
+
+          char **grown = realloc (*list, len * sizeof (char *)) ;
+          if (grown == NULL)
+               return 1 ;
+
+          *list = grown ;
+          *max = len ;
+     }
+
+     (*list)[*cnt] = strdup (path) ;
+     if ((*list)[*cnt] == NULL)
+          return 1 ;
+
+     *cnt += 1 ;
+
+     return 0 ;
+}
+
+static int list_dir (char ***list, unsigned int *cnt, unsigned int *max, char *path)
+{
+     DIR *dir = opendir (path) ;
+     if (dir == NULL)
+          return 1 ;
+
+     struct dirent *entry = NULL ;
+     char file[4096] ;
+     int error = 0 ;
+
+     while ((entry = readdir (dir)) != NULL)
+     {
+          unsigned int len = strlen (entry->d_name) ;
+
+          if (len < 5 || strcmp (entry->d_name + len - 4, ".mds") != 0)
+               continue ;
+
+          snprintf (file, sizeof (file), "%s/%s", path, entry->d_name) ;
+
+          if (add_path (list, cnt, max, file) != 0)
+               { error = 2 ; break ; }
+     }
+
+     closedir (dir) ;
+
+     return error ;
+}
+
+static int comp_path (const void *a, const void *b)
+{
+     return strcmp (*(char **) a, *(char **) b) ;
+}
+
+static int test_mds (char *path, char *line)
+{
+     MDS mds = {0} ;
+
+     int fd = open (path, O_RDONLY) ;
+     if (fd < 0)
+     {
+          snprintf (line, 160, "%s\t-\tNo file\n", path) ;
+          return 1 ;
+     }
+
+     int error = peek_mds (fd, &mds) ;
+
+     close (fd) ;
+
+     if (error != 0)
+     {
+          snprintf (line, 160, "%s\t-\t%s\n", path, text_mds (error)) ;
+          return 2 ;
+     }
+
+     snprintf (line, 160, "%s\t%s\t%s\t%d\t%d\t%d\t%ld\n",
+               path, mds.cd ? "CD" : "DVD", mds.mod, mds.lay, mds.itv, mds.smp, mds.sct) ;
+
+     return 0 ;
+}
+
+static void *work_job (void *arg)
+{
+     JOB *job = arg ;
+
+     while (true)
+     {
+          unsigned int num = __atomic_fetch_add (&job->next, 1, __ATOMIC_RELAXED) ;
+          if (num >= job->cnt)
+               break ;
+
+          test_mds (job->path[num], job->line[num]) ;
+
+          // print finished lines in listing order
+
+          pthread_mutex_lock (&job->lock) ;
+
+          job->done[num] = true ;
+
+          while (job->shown < job->cnt && job->done[job->shown])
+          {
+               fputs (job->line[job->shown], stdout) ;
+               job->shown += 1 ;
+          }
+
+          pthread_mutex_unlock (&job->lock) ;
+     }
+
+     return NULL ;
+}
+
+int find_mds (char **path, int count, char ***list, unsigned int *cnt)
+{
+     // files given and files of the directories given, in name order
+
+     unsigned int max = 0 ;
+
+     for (int i = 0 ; i < count ; i++)
+     {
+          DIR *dir = opendir (path[i]) ;
+          int error = 0 ;
+
+          if (dir != NULL)
+          {
+               closedir (dir) ;
+               error = list_dir (list, cnt, &max, path[i]) ;
+          }
+          else error = add_path (list, cnt, &max, path[i]) ;
+
+          if (error != 0)
+               return error ;
+     }
+
+     qsort (*list, *cnt, sizeof (char *), comp_path) ;
+
+     return 0 ;
+}
+
+int triage (char **path, int count, unsigned int jobs)
+{
+     char **list = NULL ;
+     unsigned int cnt = 0 ;
+
+     int error = find_mds (path, count, &list, &cnt) ;
+     if (error != 0)
+          goto quit ;
+
+     JOB job = {0} ;
+
+     job.path = list ;
+     job.cnt = cnt ;
+     job.line = calloc (cnt, sizeof (*job.line)) ;
+     job.done = calloc (cnt, sizeof (bool)) ;
+
+     if (cnt > 0 && (job.line == NULL || job.done == NULL))
+          { error = 3 ; goto clean ; }
+
+     if (jobs == 0)
+          jobs = sysconf (_SC_NPROCESSORS_ONLN) ;
+     if (jobs > cnt)
+          jobs = cnt ;
+     if (jobs > 64)
+          jobs = 64 ;
+
+     pthread_t thread[64] ;
+     unsigned int started = 0 ;
+
+     pthread_mutex_init (&job.lock, NULL) ;
+
+     for (int i = 1 ; i < jobs ; i++)
+     {
+          if (pthread_create (&thread[started], NULL, work_job, &job) != 0)
+               break ;
+          started += 1 ;
+     }
+
+     work_job (&job) ;
+
+     for (int i = 0 ; i < started ; i++)
+          pthread_join (thread[i], NULL) ;
+
+     pthread_mutex_destroy (&job.lock) ;
+
+     fflush (stdout) ;
+
+     clean :
+
+     if (job.done != NULL)
+          free (job.done) ;
+     if (job.line != NULL)
+          free (job.line) ;
+
+     quit :
+
+     for (int i = 0 ; i < cnt ; i++)
+          free (list[i]) ;
+     if (list != NULL)
+          free (list) ;
+
+     return error ;
+}
@@ -0,0 +1,56 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef TRIAGE_H
+# define TRIAGE_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <dirent.h>
+# include <fcntl.h>
+# include <unistd.h>
+# include <pthread.h>
+
+# include "type.h"
+# include "parse.h"
+
+typedef struct job
+{
+     char **path ;
+     char (*line)[160] ;
+     bool *done ;
+     unsigned int cnt ;
+     unsigned int next ;
+     unsigned int shown ;
+     pthread_mutex_t lock ;
+}
+JOB ;
+
+static int add_path (char ***list, unsigned int *cnt, unsigned int *max, char *path) ;
+static int list_dir (char ***list, unsigned int *cnt, unsigned int *max, char *path) ;
+static int comp_path (const void *a, const void *b) ;
+static int test_mds (char *path, char *line) ;
+static void *work_job (void *arg) ;
+
+int find_mds (char **path, int count, char ***list, unsigned int *cnt) ;
+int triage (char **path, int count, unsigned int jobs) ;
+
+# endif
@@ -22,6 +22,15 @@
 
 # include <stdbool.h>
 
+// hot loops are built for several instruction sets
+//  and the loader picks the best one for the running processor
+
+# if LINUX && defined (__x86_64__)
+# define KERNEL __attribute__ ((target_clones ("default", "sse4.2", "avx2", "avx512f")))
+# else
+# define KERNEL
+# endif
+
 typedef struct mds
 {
      bool cd ;
@@ -36,6 +45,10 @@ typedef struct mds
 }
 MDS ;
 
+// zero variation guard samples stored before and after the samples of a file
+
+# define DPM_PAD 4
+
 typedef struct dpm
 {
      unsigned long raw ;
@@ -44,6 +57,24 @@ typedef struct dpm
 }
 DPM ;
 
+// spread of the timings and variations of a layer, quantiles and
+//  a histogram between the first and the last percentile
+
+# define DIS_BIN 32
+
+typedef struct dis
+{
+     unsigned int tim_qnt[3] ;
+     signed int var_qnt[3] ;
+     unsigned int tim_lo ;
+     unsigned int tim_step ;
+     signed int var_lo ;
+     unsigned int var_step ;
+     unsigned int tim_hst[DIS_BIN] ;
+     unsigned int var_hst[DIS_BIN] ;
+}
+DIS ;
+
 typedef struct dsc
 {
      unsigned long inc_lba[200] ;
@@ -54,6 +85,10 @@ typedef struct dsc
      unsigned long stp_lba[10] ;
      unsigned char stt_cnt ;
      unsigned char stp_cnt ;
+     unsigned long seg_stt[10] ;
+     unsigned long seg_stp[10] ;
+     unsigned char seg_cnt ;
+     unsigned char seg_cut ;
      signed int inc_amp[2] ;
      signed int dec_amp[2] ;
      unsigned int brk_smp ;
@@ -70,9 +105,46 @@ typedef struct dsc
      float lay_0_rat ;
      float lay_1_rat ;
      unsigned int dpm_cat ;
+     unsigned int ada_win ;
+     unsigned int glt_cnt ;
+     bool glt_off ;
+     DIS dis[2] ;
+     unsigned char mtc_run ;
+     unsigned long mtc_inc[200] ;
+     unsigned long mtc_dec[200] ;
+     unsigned char mtc_inc_cnt ;
+     unsigned char mtc_dec_cnt ;
+     unsigned int tpl_cnt[2] ;
+     unsigned long mtc_tim ;
+     unsigned long spk_tim ;
 }
 DSC ;
 
+typedef struct opt
+{
+     char mode ;
+     unsigned int job ;
+     bool huge ;
+     unsigned int win ;
+     char *lib ;
+     char *tag ;
+     unsigned int top ;
+     bool sparse ;
+     bool index ;
+     bool svg ;
+     bool glitch ;
+     unsigned long sct ;
+     char *drv ;
+     char *res ;
+     char *out ;
+     unsigned int dep ;
+     char *met ;
+     char *sock ;
+     unsigned int mem ;
+     char *tpl ;
+}
+OPT ;
+
 typedef struct spk
 {
      unsigned long len[4] ;
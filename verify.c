@@ -0,0 +1,1512 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "verify.h"
+
+// references run beside the optimized paths to prove that every log stays
+//  byte for byte the same : the parser, the break, the fixed detectors, the
+//  regions and the sample lines frozen as they were before any optimization,
+//  bounded to the samples there are and returning errors instead of exiting,
+//  and slow plain versions of what came later, the median window sorted anew
+//  at every sample and the segmentation searched exhaustively
+
+static int ref_dpm (FILE *file, MDS *mds, DPM *dpm)
+{
+     unsigned int offset = 0 ;
+
+     if (mds->loc == 0x01)
+          offset = mds->ptr + 24 ;
+     else if (mds->loc == 0x02)
+          offset = mds->ptr + 28 ;
+
+     fseek (file, offset, SEEK_SET) ;
+
+     // samples missing from a truncated file, the one cut short included, read as zero
+
+     for (int i = 0 ; i < mds->smp ; i++)
+     {
+          unsigned int raw = 0 ;
+
+          if (fread (&raw, 4, 1, file) != 1)
+               raw = 0 ;
+
+          dpm[i].raw = raw ;
+     }
+
+     dpm[0].tim = dpm[0].raw ;
+     dpm[0].var = 0 ;
+
+     for (int i = 1 ; i < mds->smp ; i++)
+     {
+          dpm[i].tim = dpm[i].raw - dpm[i-1].raw ;
+          dpm[i].var = dpm[i].tim - dpm[i-1].tim ;
+     }
+
+     return 0 ;
+}
+
+static int ref_brk (MDS *mds, DPM *dpm, DSC *dsc)
+{
+     if (mds->cd || mds->lay < 2 || mds->smp < 2)
+          return 1 ;
+
+     unsigned int smp_inf = (mds->sct / 2) / mds->itv - 1 ;
+     unsigned int smp_sup = (2294922) / mds->itv - 1 ;
+
+     if (smp_sup >= mds->smp - 1)
+          smp_sup = mds->smp - 2 ;
+
+     unsigned int brk_tim = smp_inf <= smp_sup ? dpm[smp_inf].tim : 0 ;
+
+     for (int i = smp_inf ; i <= smp_sup ; i++)
+     {
+          if (brk_tim >= dpm[i].tim)
+          {
+               brk_tim = dpm[i].tim ;
+               dsc->brk_smp = i ;
+          }
+     }
+
+     dsc->brk_lba = (dsc->brk_smp + 1) * mds->itv ;
+
+     unsigned int test_smp = dsc->brk_smp + 100 ;
+     if (test_smp >= mds->smp)
+          test_smp = mds->smp - 1 ;
+
+     if (abs (dpm[dsc->brk_smp].tim - dpm[test_smp].tim) < 100)
+          sprintf (dsc->trk_pth, "opposite") ;
+     else sprintf (dsc->trk_pth, "parallel") ;
+
+     return 0 ;
+}
+
+static int ref_int (const void *a, const void *b)
+{
+     signed int x = * (const signed int *) a ;
+     signed int y = * (const signed int *) b ;
+
+     return (x > y) - (x < y) ;
+}
+
+static int ref_spk_ada (MDS *mds, DPM *dpm, DSC *dsc, int smp_stt, int smp_stp,
+                        signed int *srt, signed int *dst, unsigned int win)
+{
+     signed int var_min = 100 ;
+     signed int var_max = 400 ;
+     unsigned int skip = 1 ;
+
+     switch (mds->itv)
+     {
+          case 50 :
+               var_min = 3 ;
+               var_max = 33 ;
+               skip = 2 ;
+               break ;
+          case 256 :
+               var_min = 10 ;
+               var_max = 60 ;
+               break ;
+     }
+
+     signed int base = dpm[smp_stt].var ;
+     unsigned int next = smp_stt ;
+
+     for (int i = smp_stt ; i <= smp_stp ; i++)
+     {
+          // previous samples of the window copied and sorted, values clamped
+          //  around the first one, then their distances to the median sorted
+
+          unsigned int cnt = i - smp_stt < win ? i - smp_stt : win ;
+          signed int med = 0 ;
+          signed int mad = 0 ;
+
+          for (unsigned int j = 0 ; j < cnt ; j++)
+          {
+               signed int val = dpm[i-cnt+j].var - base ;
+
+               if (val < - OSW_BIN / 2)
+                    val = - OSW_BIN / 2 ;
+               if (val > OSW_BIN / 2 - 1)
+                    val = OSW_BIN / 2 - 1 ;
+
+               srt[j] = val ;
+          }
+
+          if (cnt > 0)
+          {
+               qsort (srt, cnt, sizeof (signed int), ref_int) ;
+
+               signed int mid = srt[(cnt - 1) / 2] ;
+
+               for (unsigned int j = 0 ; j < cnt ; j++)
+                    dst[j] = abs (srt[j] - mid) ;
+
+               qsort (dst, cnt, sizeof (signed int), ref_int) ;
+
+               med = base + mid ;
+               mad = dst[(cnt - 1) / 2] ;
+          }
+
+          signed int var = dpm[i].var ;
+          signed int dif = var - med ;
+
+          signed int lim = mad * 7413 / 1000 ;
+          if (lim < var_min)
+               lim = var_min ;
+
+          signed int top = var_max + lim - var_min ;
+
+          // samples following a spike neither counted nor detected
+
+          if (i < next)
+               continue ;
+
+          unsigned long sector = (unsigned long) (i + 1) * mds->itv ;
+
+          if (dif > lim && dif < top)
+          {
+               if (dsc->inc_cnt == 200)
+                    return 2 ;
+
+               dsc->inc_lba[dsc->inc_cnt] = sector ;
+               dsc->inc_cnt += 1 ;
+          }
+          else if (dif < -lim && dif > -top)
+          {
+               if (dsc->dec_cnt == 200)
+                    return 2 ;
+
+               dsc->dec_lba[dsc->dec_cnt] = sector ;
+               dsc->dec_cnt += 1 ;
+          }
+          else
+          {
+               dsc->var_sum += abs (var) ;
+               continue ;
+          }
+
+          next = i + 1 + skip ;
+     }
+
+     return 0 ;
+}
+
+static int ref_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer, signed int *srt, signed int *dst, unsigned int win)
+{
+     signed int var_min = 0 ;
+     signed int var_max = 0 ;
+
+     switch (mds->itv)
+     {
+          case 256 :
+               var_min = 10 ;
+               var_max = 60 ;
+               break ;
+          case 500 :
+          case 2048 :
+               var_min = 100 ;
+               var_max = 400 ;
+               break ;
+     }
+
+     unsigned int smp_stt = 0 ;
+     unsigned int smp_stp = mds->smp - 1 ;
+
+     switch (layer)
+     {
+          case 0 :
+               smp_stt = 0 ;
+               smp_stp = dsc->brk_smp ;
+               break ;
+          case 1 :
+               smp_stt = dsc->brk_smp + 1 ;
+               smp_stp = mds->smp - 1 ;
+               break ;
+     }
+
+     unsigned long sector = (unsigned long) smp_stt * mds->itv ;
+     dsc->var_sum = 0 ;
+
+     if (win != 0 && ref_spk_ada (mds, dpm, dsc, smp_stt, smp_stp, srt, dst, win) != 0)
+          return 2 ;
+
+     for (int i = smp_stt ; win == 0 && i <= smp_stp ; i++)
+     {
+          sector += mds->itv ;
+
+          // spike increase detection
+
+          if (dpm[i].var > var_min && dpm[i].var < var_max)
+          {
+               if (dsc->inc_cnt == 200)
+                    return 2 ;
+
+               dsc->inc_lba[dsc->inc_cnt] = sector ;
+               dsc->inc_cnt += 1 ;
+               i += 1 ;
+               sector += mds->itv ;
+               continue ;
+          }
+
+          // spike decrease detection
+
+          if (dpm[i].var < -var_min && dpm[i].var > -var_max)
+          {
+               if (dsc->dec_cnt == 200)
+                    return 2 ;
+
+               dsc->dec_lba[dsc->dec_cnt] = sector ;
+               dsc->dec_cnt += 1 ;
+               i += 1 ;
+               sector += mds->itv ;
+               continue ;
+          }
+
+          dsc->var_sum += abs (dpm[i].var) ;
+     }
+
+     dsc->var_rat = (float) abs (dpm[smp_stt].tim - dpm[smp_stp].tim) * 100 / dsc->var_sum ;
+
+     switch (layer)
+     {
+          case 0 :
+               dsc->lay_0_sum = dsc->var_sum ;
+               dsc->lay_0_rat = dsc->var_rat ;
+               break ;
+          case 1 :
+               dsc->lay_1_sum = dsc->var_sum ;
+               dsc->lay_1_rat = dsc->var_rat ;
+               break ;
+     }
+
+     return 0 ;
+}
+
+static int ref_spk_50 (MDS *mds, DPM *dpm, DSC *dsc)
+{
+     unsigned long sector = 0 ;
+
+     for (int i = 0 ; i < mds->smp ; i++)
+     {
+          sector += mds->itv ;
+
+          // spike increase detection
+
+          if (dpm[i].var > 3 && dpm[i].var < 33 && dpm[i].var + dpm[i+1].var > 13)
+          {
+               // false positive caused by variation artifact or by previous increase
+
+               if (dpm[i-2].var + dpm[i-1].var < -9 || dpm[i+2].var + dpm[i+3].var < -9 || dpm[i-1].var > 9)
+               {
+                    dsc->err_cnt += 1 ;
+                    dsc->var_sum += abs (dpm[i].var) ;
+                    continue ;
+               }
+
+               if (dsc->inc_cnt == 200)
+                    return 2 ;
+
+               dsc->inc_lba[dsc->inc_cnt] = sector ;
+               dsc->inc_cnt += 1 ;
+               i += 2 ;
+               sector += mds->itv * 2 ;
+               continue ;
+          }
+
+          // spike decrease detection
+
+          if (dpm[i].var < -3 && dpm[i].var > -33 && dpm[i].var + dpm[i+1].var < -13)
+          {
+               // false positive caused by variation artifact or by previous decrease
+
+               if (dpm[i-2].var + dpm[i-1].var > 9 || dpm[i+2].var + dpm[i+3].var > 9 || dpm[i-1].var < -9)
+               {
+                    dsc->err_cnt += 1 ;
+                    dsc->var_sum += abs (dpm[i].var) ;
+                    continue ;
+               }
+
+               if (dsc->dec_cnt == 200)
+                    return 2 ;
+
+               dsc->dec_lba[dsc->dec_cnt] = sector ;
+
+               if (dpm[i+1].var < -3)
+                    dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
+
+               if (dpm[i+1].var < -3 && dpm[i+2].var < -3)
+                    dsc->dec_lba[dsc->dec_cnt] += mds->itv ;
+
+               dsc->dec_cnt += 1 ;
+               i += 2 ;
+               sector += mds->itv * 2 ;
+               continue ;
+          }
+
+          dsc->var_sum += abs (dpm[i].var) ;
+     }
+
+     dsc->var_rat = (float) (dpm[0].tim - dpm[mds->smp-1].tim) * 100 / dsc->var_sum ;
+
+     return 0 ;
+}
+
+static unsigned int ref_glt (MDS *mds, DPM *dpm, int mode)
+{
+     signed int lim = mds->itv == 50 ? 33 : mds->itv == 256 ? 60 : 400 ;
+     unsigned int count = 0 ;
+
+     for (int i = 1 ; i < (signed int) mds->smp - 1 ; i++)
+     {
+          signed int bef = dpm[i].tim - dpm[i-1].tim ;
+          signed int aft = dpm[i+1].tim - dpm[i].tim ;
+
+          if (abs (bef + aft) > lim / 2)
+               continue ;
+
+          if ((bef > lim && aft < -lim) || (bef < -lim && aft > lim))
+          {
+               if (mode == GLT_DROP)
+               {
+                    dpm[i].var = (signed int) (dpm[i+1].tim - dpm[i-1].tim) ;
+                    dpm[i+1].var = 0 ;
+               }
+               else if (mode == GLT_BACK)
+               {
+                    dpm[i].var = bef ;
+                    dpm[i+1].var = aft ;
+               }
+
+               count += 1 ;
+               i += 1 ;
+          }
+     }
+
+     return count ;
+}
+
+static int ref_dis (DPM *dpm, int smp_stt, int smp_stp, DIS *dis, unsigned int *cnt)
+{
+     if (smp_stp < smp_stt)
+          return 1 ;
+
+     unsigned int total = smp_stp - smp_stt + 1 ;
+
+     unsigned long raw = dpm[smp_stp].raw - (smp_stt > 0 ? dpm[smp_stt-1].raw : 0) ;
+     unsigned int avg = raw / total ;
+     unsigned int tim_lo = avg > DIS_SPAN / 2 ? avg - DIS_SPAN / 2 : 0 ;
+
+     unsigned int *tim_cnt = cnt ;
+     unsigned int *var_cnt = cnt + DIS_SPAN ;
+
+     memset (cnt, 0, 2 * DIS_SPAN * sizeof (unsigned int)) ;
+
+     for (int i = smp_stt ; i <= smp_stp ; i++)
+     {
+          int tim = (int) dpm[i].tim - (int) tim_lo ;
+          int var = dpm[i].var + DIS_SPAN / 2 ;
+
+          if (tim < 0)
+               tim = 0 ;
+          if (tim > DIS_SPAN - 1)
+               tim = DIS_SPAN - 1 ;
+          if (var < 0)
+               var = 0 ;
+          if (var > DIS_SPAN - 1)
+               var = DIS_SPAN - 1 ;
+
+          tim_cnt[tim] += 1 ;
+          var_cnt[var] += 1 ;
+     }
+
+     // nearest rank percentiles, then bins of equal width between the outer two
+
+     int qnt[2][3] = { {0}, {0} } ;
+
+     for (int h = 0 ; h < 2 ; h++)
+     {
+          unsigned int *c = h == 0 ? tim_cnt : var_cnt ;
+          unsigned int *hst = h == 0 ? dis->tim_hst : dis->var_hst ;
+          unsigned int *step = h == 0 ? &dis->tim_step : &dis->var_step ;
+
+          unsigned int rank[3] = { (total + 99) / 100, (total * 50 + 99) / 100, (total * 99 + 99) / 100 } ;
+          unsigned int sum = 0 ;
+          int q = 0 ;
+
+          for (int b = 0 ; b < DIS_SPAN && q < 3 ; b++)
+          {
+               sum += c[b] ;
+
+               while (q < 3 && sum >= (rank[q] ? rank[q] : 1))
+                    qnt[h][q++] = b ;
+          }
+
+          *step = (qnt[h][2] - qnt[h][0] + DIS_BIN) / DIS_BIN ;
+
+          for (int b = 0 ; b < DIS_SPAN ; b++)
+          {
+               if (c[b] == 0)
+                    continue ;
+
+               int bin = b < qnt[h][0] ? 0 : (b - qnt[h][0]) / (int) *step ;
+
+               if (bin > DIS_BIN - 1)
+                    bin = DIS_BIN - 1 ;
+
+               hst[bin] += c[b] ;
+          }
+     }
+
+     for (int q = 0 ; q < 3 ; q++)
+     {
+          dis->tim_qnt[q] = tim_lo + qnt[0][q] ;
+          dis->var_qnt[q] = qnt[1][q] - DIS_SPAN / 2 ;
+     }
+
+     dis->tim_lo = dis->tim_qnt[0] ;
+     dis->var_lo = dis->var_qnt[0] ;
+
+     return 0 ;
+}
+
+static int ref_dist (MDS *mds, DPM *dpm, DSC *dsc, ARN *arn)
+{
+     if (mds->smp == 0)
+          return 1 ;
+
+     unsigned int *cnt = take_arn (arn, 2 * DIS_SPAN * sizeof (unsigned int)) ;
+     if (cnt == NULL)
+          return 2 ;
+
+     if (mds->lay == 2 && dsc->brk_smp + 1 < mds->smp)
+     {
+          ref_dis (dpm, 0, dsc->brk_smp, &dsc->dis[0], cnt) ;
+          ref_dis (dpm, dsc->brk_smp + 1, mds->smp - 1, &dsc->dis[1], cnt) ;
+     }
+     else ref_dis (dpm, 0, mds->smp - 1, &dsc->dis[0], cnt) ;
+
+     return 0 ;
+}
+
+static int ref_amp (MDS *mds, DPM *dpm, DSC *dsc)
+{
+     if (dsc->inc_cnt)
+     {
+          unsigned int fis = dsc->inc_lba[0] / mds->itv - 1 ;
+          unsigned int lis = dsc->inc_lba[dsc->inc_cnt-1] / mds->itv - 1 ;
+
+          dsc->inc_amp[0] = dpm[fis].var + dpm[fis+1].var + dpm[fis+2].var ;
+          dsc->inc_amp[1] = dpm[lis].var + dpm[lis+1].var + dpm[lis+2].var ;
+     }
+
+     if (dsc->dec_cnt)
+     {
+          signed int fds = dsc->dec_lba[0] / mds->itv - 1 ;
+          signed int lds = dsc->dec_lba[dsc->dec_cnt-1] / mds->itv - 1 ;
+
+          dsc->dec_amp[0] = dpm[fds].var + dpm[fds-1].var + dpm[fds-2].var ;
+          dsc->dec_amp[1] = dpm[lds].var + dpm[lds-1].var + dpm[lds-2].var ;
+     }
+
+     return 0 ;
+}
+
+static int ref_reg (MDS *mds, DSC *dsc)
+{
+     unsigned int threshold = 0 ;
+
+     if (mds->cd)
+          threshold = 4000 ;
+     else if (mds->dvd)
+          threshold = 40000 ;
+
+     // region start detection
+
+     if (dsc->inc_cnt > 0)
+     {
+          dsc->stt_lba[0] = dsc->inc_lba[0] ;
+          dsc->stt_cnt += 1 ;
+     }
+
+     for (int i = 1 ; i < dsc->inc_cnt ; i++)
+     {
+          if (dsc->inc_lba[i] - dsc->inc_lba[i-1] > threshold)
+          {
+               if (dsc->stt_cnt == 10)
+                    return 2 ;
+
+               dsc->stt_lba[dsc->stt_cnt] = dsc->inc_lba[i] ;
+               dsc->stt_cnt += 1 ;
+          }
+     }
+
+     // region stop detection
+
+     for (int i = 1 ; i < dsc->dec_cnt ; i++)
+     {
+          if (dsc->dec_lba[i] - dsc->dec_lba[i-1] > threshold)
+          {
+               if (dsc->stp_cnt == 9)
+                    return 2 ;
+
+               dsc->stp_lba[dsc->stp_cnt] = dsc->dec_lba[i-1] ;
+               dsc->stp_cnt += 1 ;
+          }
+     }
+
+     if (dsc->dec_cnt > 0)
+     {
+          dsc->stp_lba[dsc->stp_cnt] = dsc->dec_lba[dsc->dec_cnt-1] ;
+          dsc->stp_cnt += 1 ;
+     }
+
+     return 0 ;
+}
+
+static unsigned int ref_part (SPL *spl, DPM *dpm, int smp_stt, int smp_stp, double pen)
+{
+     unsigned int num = smp_stp - smp_stt + 1 ;
+
+     spl->sum[0] = 0 ;
+     spl->sqr[0] = 0 ;
+
+     for (unsigned int i = 0 ; i < num ; i++)
+     {
+          signed long tim = (signed long) dpm[smp_stt+i].tim - dpm[smp_stt].tim ;
+
+          spl->sum[i+1] = spl->sum[i] + tim ;
+          spl->sqr[i+1] = spl->sqr[i] + (__int128) tim * tim ;
+     }
+
+     // optimal partitioning, every earlier end tried for every sample,
+     //  the first of equal costs kept
+
+     spl->cst[0] = - pen ;
+
+     for (unsigned int t = 1 ; t <= num ; t++)
+     {
+          double best = INFINITY ;
+          unsigned int last = 0 ;
+
+          for (unsigned int s = 0 ; s < t ; s++)
+          {
+               signed long sum = spl->sum[t] - spl->sum[s] ;
+               __int128 sqr = spl->sqr[t] - spl->sqr[s] ;
+               double cst = spl->cst[s] + (double) (sqr * (t - s) - (__int128) sum * sum) / (t - s) ;
+
+               if (cst < best)
+                    { best = cst ; last = s ; }
+          }
+
+          spl->cst[t] = best + pen ;
+          spl->lst[t] = last ;
+     }
+
+     unsigned int cnt = 0 ;
+
+     for (unsigned int t = num ; t > 0 ; t = spl->lst[t])
+          spl->cnd[cnt++] = t ;
+
+     for (unsigned int i = 0 ; i < cnt / 2 ; i++)
+     {
+          unsigned int tmp = spl->cnd[i] ;
+          spl->cnd[i] = spl->cnd[cnt-1-i] ;
+          spl->cnd[cnt-1-i] = tmp ;
+     }
+
+     return cnt ;
+}
+
+static int ref_seg (MDS *mds, DSC *dsc, SPL *spl, int smp_stt, unsigned int cnt, unsigned int itv)
+{
+     unsigned int threshold = 0 ;
+
+     if (mds->cd)
+          threshold = 4000 ;
+     else if (mds->dvd)
+          threshold = 40000 ;
+
+     double step = 100 ;
+
+     switch (itv)
+     {
+          case 50 :
+               step = 13 ;
+               break ;
+          case 256 :
+               step = 10 ;
+               break ;
+     }
+
+     step = step * itv / mds->itv ;
+
+     unsigned long prv_lba = 0 ;
+     bool open = false ;
+     bool kept = false ;
+
+     for (unsigned int k = 0 ; k < cnt ; k++)
+     {
+          unsigned int stt = k > 0 ? spl->cnd[k-1] : 0 ;
+          unsigned int stp = spl->cnd[k] ;
+
+          double avg = (double) (spl->sum[stp] - spl->sum[stt]) / (stp - stt) ;
+
+          bool high = cnt > 1 ;
+
+          if (k > 0)
+          {
+               unsigned int bef = k > 1 ? spl->cnd[k-2] : 0 ;
+               high &= avg - (double) (spl->sum[stt] - spl->sum[bef]) / (stt - bef) > step ;
+          }
+
+          if (k < cnt - 1)
+          {
+               unsigned int aft = spl->cnd[k+1] ;
+               high &= avg - (double) (spl->sum[aft] - spl->sum[stp]) / (aft - stp) > step ;
+          }
+
+          if (! high || stp - stt < SPL_MIN)
+               continue ;
+
+          unsigned long stt_lba = (unsigned long) (smp_stt + stt + 1) * mds->itv ;
+          unsigned long stp_lba = (unsigned long) (smp_stt + stp + 1) * mds->itv ;
+
+          if (open && stt_lba - prv_lba <= threshold)
+          {
+               if (kept)
+                    dsc->seg_stp[dsc->seg_cnt-1] = stp_lba ;
+          }
+          else if (dsc->seg_cnt == 10)
+          {
+               if (dsc->seg_cut < 255)
+                    dsc->seg_cut += 1 ;
+               kept = false ;
+          }
+          else
+          {
+               dsc->seg_stt[dsc->seg_cnt] = stt_lba ;
+               dsc->seg_stp[dsc->seg_cnt] = stp_lba ;
+               dsc->seg_cnt += 1 ;
+               kept = true ;
+          }
+
+          prv_lba = stt_lba ;
+          open = true ;
+     }
+
+     return dsc->seg_cut != 0 ;
+}
+
+static int ref_split (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn)
+{
+     SPL spl = {0} ;
+
+     int smp_stt[2] = {0, 0} ;
+     int smp_stp[2] = {mds->smp - 1, 0} ;
+     int lay_cnt = 1 ;
+
+     if (mds->lay == 2 && mds->itv != 50)
+     {
+          smp_stp[0] = dsc->brk_smp ;
+          smp_stt[1] = dsc->brk_smp + 1 ;
+          smp_stp[1] = mds->smp - 1 ;
+          lay_cnt = 2 ;
+     }
+
+     // too long a layer to be searched exhaustively, its regions taken
+     //  from the optimized segmentation and left unchecked
+
+     for (int l = 0 ; l < lay_cnt ; l++)
+     {
+          if (smp_stp[l] - smp_stt[l] + 1 > TST_OPT)
+               return split_dpm (mds, dpm, dsc, itv, arn) ;
+     }
+
+     spl.sum = take_arn (arn, (mds->smp + 1) * sizeof (signed long)) ;
+     spl.sqr = take_arn (arn, (mds->smp + 1) * sizeof (__int128)) ;
+     spl.cst = take_arn (arn, (mds->smp + 1) * sizeof (double)) ;
+     spl.lst = take_arn (arn, (mds->smp + 1) * sizeof (unsigned int)) ;
+     spl.cnd = take_arn (arn, (mds->smp + 1) * sizeof (unsigned int)) ;
+
+     if (spl.sum == NULL || spl.sqr == NULL || spl.cst == NULL || spl.lst == NULL || spl.cnd == NULL)
+          return 2 ;
+
+     int state = 0 ;
+
+     for (int l = 0 ; l < lay_cnt ; l++)
+     {
+          if (smp_stp[l] <= smp_stt[l])
+               continue ;
+
+          // noise from the median absolute variation, counted one by one
+
+          unsigned int cnt[256] = {0} ;
+          unsigned int num = smp_stp[l] - smp_stt[l] + 1 ;
+
+          for (int i = smp_stt[l] ; i <= smp_stp[l] ; i++)
+          {
+               unsigned int var = abs (dpm[i].var) ;
+               cnt[var < 255 ? var : 255] += 1 ;
+          }
+
+          unsigned int med = 0 ;
+          unsigned int low = 0 ;
+
+          while (low + cnt[med] <= num / 2)
+               low += cnt[med++] ;
+
+          double dev = 1.4826 * (med > 0 ? med : 0.5) ;
+          double pen = 3 * (dev * dev / 2) * log (smp_stp[l] - smp_stt[l] + 1) ;
+
+          unsigned int seg = ref_part (&spl, dpm, smp_stt[l], smp_stp[l], pen) ;
+
+          state |= ref_seg (mds, dsc, &spl, smp_stt[l], seg, itv) ;
+     }
+
+     return state ;
+}
+
+static int ref_cat (DSC *dsc)
+{
+     if (dsc->stt_cnt == 0 && dsc->stp_cnt == 0)
+          return 1 ;
+     else if (dsc->inc_cnt != dsc->dec_cnt || dsc->stt_cnt != dsc->stp_cnt)
+          return 2 ;
+     else if (dsc->dec_cnt % dsc->stp_cnt != 0)
+          return 2 ;
+
+     unsigned char reg_cnt = dsc->stp_cnt ;
+     unsigned char spk_cnt = dsc->dec_cnt ;
+     unsigned char spr_cnt = dsc->dec_cnt / dsc->stp_cnt ;
+
+     unsigned char ipr_cnt = 0 ;
+     unsigned char dpr_cnt = 0 ;
+     unsigned char inc_num = 0 ;
+     unsigned char dec_num = 0 ;
+
+     for (int i = 0 ; i < reg_cnt ; i++)
+     {
+          ipr_cnt = 0 ;
+          dpr_cnt = 0 ;
+
+          for (int j = inc_num ; j < spk_cnt ; j++)
+          {
+               if (dsc->inc_lba[j] >= dsc->stt_lba[i] && dsc->inc_lba[j] < dsc->stp_lba[i])
+                    ipr_cnt += 1 ;
+               else break ;
+          }
+
+          inc_num += ipr_cnt ;
+
+          for (int j = dec_num ; j < spk_cnt ; j++)
+          {
+               if (dsc->dec_lba[j] <= dsc->stp_lba[i] && dsc->dec_lba[j] > dsc->stt_lba[i])
+                    dpr_cnt += 1 ;
+               else break ;
+          }
+
+          dec_num += dpr_cnt ;
+
+          if (ipr_cnt != spr_cnt || dpr_cnt != spr_cnt)
+               return 2 ;
+     }
+
+     return 0 ;
+}
+
+static int ref_len (DSC *dsc, SPK *spk)
+{
+     unsigned char reg_cnt = dsc->stp_cnt ;
+     unsigned char spr_cnt = dsc->dec_cnt / dsc->stp_cnt ;
+
+     for (int i = 0 ; i < spr_cnt ; i++)
+     {
+          for (int j = 0 ; j < reg_cnt ; j++)
+          {
+               spk[i].len[j] = dsc->dec_lba[i+j*spr_cnt] - dsc->inc_lba[i+j*spr_cnt] ;
+               spk[i].avg += (float) spk[i].len[j] ;
+          }
+
+          spk[i].avg /= (float) reg_cnt ;
+
+          for (int j = 0 ; j < reg_cnt ; j++)
+          {
+               float avg_dev = spk[i].len[j] - spk[i].avg ;
+               spk[i].dev += avg_dev * avg_dev ;
+          }
+
+          spk[i].dev = sqrtf (spk[i].dev / reg_cnt) ;
+     }
+
+     return 0 ;
+}
+
+static int ref_eval (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk, OPT *opt, ARN *arn)
+{
+     // same states as eval_dpm with the same window and glitch options
+
+     int state = 0 ;
+
+     ref_brk (mds, dpm, dsc) ;
+
+     signed int *srt = NULL ;
+     signed int *dst = NULL ;
+
+     if (opt->win != 0)
+     {
+          srt = take_arn (arn, opt->win * sizeof (signed int)) ;
+          dst = take_arn (arn, opt->win * sizeof (signed int)) ;
+
+          if (srt == NULL || dst == NULL)
+               return 2 ;
+
+          dsc->ada_win = opt->win ;
+     }
+
+     dsc->glt_cnt = ref_glt (mds, dpm, opt->glitch ? GLT_DROP : GLT_FIND) ;
+     dsc->glt_off = opt->glitch ;
+
+     if (mds->itv == 50 && opt->win == 0)
+     {
+          dsc->tim_avg = dpm[mds->smp-1].raw / mds->smp ;
+          state |= ref_spk_50 (mds, dpm, dsc) ;
+     }
+     else if (mds->lay == 2)
+     {
+          dsc->lay_0_avg = dpm[dsc->brk_smp].raw / (dsc->brk_smp+1) ;
+          state |= ref_spk (mds, dpm, dsc, 0, srt, dst, opt->win) ;
+          dsc->lay_1_avg = (dpm[mds->smp-1].raw - dpm[dsc->brk_smp].raw) / (mds->smp - (dsc->brk_smp+1)) ;
+          state |= ref_spk (mds, dpm, dsc, 1, srt, dst, opt->win) ;
+     }
+     else
+     {
+          dsc->tim_avg = dpm[mds->smp-1].raw / mds->smp ;
+          state |= ref_spk (mds, dpm, dsc, -1, srt, dst, opt->win) ;
+     }
+
+     if (opt->glitch)
+          ref_glt (mds, dpm, GLT_BACK) ;
+
+     if (state != 0)
+          return 3 ;
+
+     if (ref_dist (mds, dpm, dsc, arn) == 2)
+          return 2 ;
+
+     ref_amp (mds, dpm, dsc) ;
+
+     if (ref_reg (mds, dsc) != 0)
+          return 3 ;
+
+     if (ref_split (mds, dpm, dsc, mds->itv, arn) == 2)
+          return 2 ;
+
+     dsc->dpm_cat = ref_cat (dsc) ;
+     if (dsc->dpm_cat != 0)
+          return 1 ;
+
+     *spk = take_arn (arn, dsc->dec_cnt / dsc->stp_cnt * sizeof (SPK)) ;
+     if (*spk == NULL)
+          return 2 ;
+
+     ref_len (dsc, *spk) ;
+
+     return 0 ;
+}
+
+static int ref_log (FILE *file, MDS *mds, DPM *dpm, DSC *dsc)
+{
+     unsigned long sector = 0 ;
+     unsigned char inc_num = 0 ;
+     unsigned char dec_num = 0 ;
+     char mark = '|' ;
+
+     for (int i = 0 ; i < mds->smp ; i++)
+     {
+          sector += mds->itv ;
+
+          if (inc_num < dsc->inc_cnt && sector == dsc->inc_lba[inc_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   INCREASE # %d\n", inc_num + 1) ;
+               mark = '>' ;
+               inc_num += 1 ;
+          }
+          else if (dec_num < dsc->dec_cnt && sector == dsc->dec_lba[dec_num])
+          {
+               fprintf (file, "\t\t\t\t\t\t\t\t   DECREASE # %d\n", dec_num + 1) ;
+               mark = '|' ;
+               dec_num += 1 ;
+          }
+
+          fprintf (file, "[%07ld - %07ld] %08ld %d %+d \t %c\n",
+                   sector - mds->itv, sector, dpm[i].raw, dpm[i].tim, dpm[i].var, mark) ;
+     }
+
+     return 0 ;
+}
+
+static unsigned int next_gen (unsigned int *seed)
+{
+     *seed ^= *seed << 13 ;
+     *seed ^= *seed >> 17 ;
+     *seed ^= *seed << 5 ;
+
+     return *seed ;
+}
+
+static unsigned char *make_gen (GEN *gen, size_t *len)
+{
+     // whole file in memory, header then cumulative timings
+
+     unsigned int head = gen->ptr + (gen->loc == 0x02 ? 28 : 24) ;
+     unsigned int seed = gen->smp * 2654435761U + gen->itv + gen->ptr + gen->shape + 1 ;
+
+     unsigned char *buf = calloc (head + gen->smp * 4, 1) ;
+     signed int *tim = calloc (gen->smp, sizeof (signed int)) ;
+
+     if (buf == NULL || tim == NULL)
+          { free (buf) ; free (tim) ; return NULL ; }
+
+     memcpy (buf, "MEDIA DESCRIPTOR", 16) ;
+     buf[0x11] = 0x05 ;
+     buf[0x12] = gen->dvd ? 0x10 : 0x00 ;
+     buf[0x54] = gen->ptr & 0xFF ;
+     buf[0x55] = gen->ptr >> 8 ;
+     buf[0x168] = 0x0A ;
+
+     unsigned long sct = (unsigned long) gen->smp * gen->itv - next_gen (&seed) % gen->itv ;
+     unsigned int at = (gen->itv == 50 || gen->itv == 500) ? 100 : gen->ptr - MDS_BACK ;
+
+     for (int b = 0 ; b < 3 ; b++)
+          buf[at+b] = sct >> (8 * b) ;
+
+     unsigned int off = gen->ptr + (gen->loc == 0x02 ? 20 : 16) ;
+
+     buf[gen->ptr] = gen->loc ;
+     buf[off] = gen->itv & 0xFF ;
+     buf[off+1] = gen->itv >> 8 ;
+     buf[off+4] = gen->smp & 0xFF ;
+     buf[off+5] = gen->smp >> 8 ;
+
+     // slow decline, a jump at the break of double layer discs, some noise
+
+     signed int base = gen->itv == 50 ? 600 : 3000 ;
+     signed int amp = gen->itv == 50 ? 20 : gen->itv == 256 ? 30 : 200 ;
+     signed int noise = gen->itv == 50 ? 1 : 2 ;
+     unsigned int brk = gen->ptr == 0x20EC ? gen->smp / 2 : gen->smp ;
+
+     for (int i = 0 ; i < gen->smp ; i++)
+     {
+          tim[i] = base - (signed int) ((long) i * 200 / gen->smp) ;
+
+          if (i > brk)
+               tim[i] = base - 300 + (signed int) ((long) (i - brk) * 200 / gen->smp) ;
+
+          tim[i] += (signed int) (next_gen (&seed) % (2 * noise + 1)) - noise ;
+
+          // every timing the same, as over a blank stretch
+
+          if (gen->shape == GEN_FLAT)
+               tim[i] = base ;
+     }
+
+     // spikes of growing length, in regions, at both ends or everywhere
+
+     unsigned int stt[64] ;
+     unsigned int cnt = 0 ;
+
+     switch (gen->shape)
+     {
+          case GEN_REG :
+          case GEN_CUT :
+               for (int r = 0 ; r < 3 ; r++)
+                    for (int s = 0 ; s < 4 ; s++)
+                         stt[cnt++] = gen->smp * (1 + 8 * r / 3) / 10 + s * 12 ;
+               break ;
+          case GEN_END :
+               stt[cnt++] = 1 ;
+               stt[cnt++] = gen->smp >= 4 ? gen->smp - 4 : 0 ;
+               stt[cnt++] = gen->smp >= 2 ? gen->smp - 2 : 0 ;
+               break ;
+     }
+
+     for (int s = 0 ; s < cnt ; s++)
+          for (int k = stt[s] ; k < stt[s] + 4 + s % 4 && k < gen->smp ; k++)
+               tim[k] += amp ;
+
+     // isolated glitches away from the spikes, beyond their amplitude
+
+     if (gen->shape == GEN_REG && gen->smp >= 1000)
+     {
+          tim[gen->smp / 20] += 8 * amp ;
+          tim[gen->smp * 19 / 20] -= 8 * amp ;
+     }
+
+     if (gen->shape == GEN_DENSE)
+          for (int k = 0 ; k < gen->smp ; k++)
+               tim[k] += k % 6 < 3 ? amp : 0 ;
+
+     unsigned int raw = 0 ;
+
+     for (int i = 0 ; i < gen->smp ; i++)
+     {
+          raw += tim[i] ;
+
+          for (int b = 0 ; b < 4 ; b++)
+               buf[head+4*i+b] = raw >> (8 * b) ;
+     }
+
+     free (tim) ;
+
+     // a truncated file stops in the middle of a sample
+
+     *len = head + gen->smp * 4 ;
+
+     if (gen->shape == GEN_CUT)
+          *len = head + gen->smp / 2 * 4 + 2 ;
+
+     return buf ;
+}
+
+static float rate_tst (unsigned long ref, unsigned long opt)
+{
+     return opt != 0 ? (float) ref / opt : 0 ;
+}
+
+static int test_dpm (char *tag, FILE *file, OPT *opt, TST *tst)
+{
+     MDS mds = {0} ;
+     ARN arn[2] = { {0}, {0} } ;
+     DPM *dpm[2] = {NULL, NULL} ;
+     SPK *spk[2] = {NULL, NULL} ;
+     DSC dsc[2] ;
+     char *txt[3] = {NULL, NULL, NULL} ;
+     size_t len[3] = {0, 0, 0} ;
+
+     unsigned long tim[2][3] = { {0} } ;
+     unsigned long tick = 0 ;
+     int state[2] = {0, 0} ;
+     char fail[32] = "" ;
+
+     int error = 0 ;
+
+     if (read_mds (file, &mds) != 0 || mds.smp == 0)
+          { printf ("%s\t-\tNot checked\n", tag) ; return 1 ; }
+
+     for (int p = 0 ; p < 2 ; p++)
+     {
+          if (make_arn (&arn[p], size_arn (&mds, opt, tag), false) == 0)
+               dpm[p] = make_dpm (&arn[p], mds.smp) ;
+
+          if (dpm[p] == NULL)
+               { printf ("%s\t-\tNot checked\n", tag) ; error = 1 ; goto quit ; }
+     }
+
+     // parse, guard samples included
+
+     tick = time_met () ;
+     read_dpm (file, &mds, dpm[0]) ;
+     tim[0][TST_PARSE] = time_met () - tick ;
+
+     tick = time_met () ;
+     ref_dpm (file, &mds, dpm[1]) ;
+     tim[1][TST_PARSE] = time_met () - tick ;
+
+     if (memcmp (dpm[0] - DPM_PAD, dpm[1] - DPM_PAD, (mds.smp + 2 * DPM_PAD) * sizeof (DPM)))
+          { strcat (fail, " parse") ; goto show ; }
+
+     // analysis, an abnormal dump stopping midway with partial sums
+
+     memset (dsc, 0, sizeof (dsc)) ;
+
+     tick = time_met () ;
+     state[0] = eval_dpm (&mds, dpm[0], &dsc[0], &spk[0], opt, &arn[0]) ;
+     tim[0][TST_EVAL] = time_met () - tick ;
+
+     tick = time_met () ;
+     state[1] = ref_eval (&mds, dpm[1], &dsc[1], &spk[1], opt, &arn[1]) ;
+     tim[1][TST_EVAL] = time_met () - tick ;
+
+     if (state[0] != state[1])
+          { strcat (fail, " state") ; goto show ; }
+     if (state[0] > 1)
+          goto show ;
+
+     if (memcmp (&dsc[0], &dsc[1], sizeof (DSC)))
+          strcat (fail, " dsc") ;
+     if (state[0] == 0 && memcmp (spk[0], spk[1], dsc[0].dec_cnt / dsc[0].stp_cnt * sizeof (SPK)))
+          strcat (fail, " spk") ;
+     if (fail[0] != 0)
+          goto show ;
+
+     // whole log, the head being shared, the sample lines written
+     //  by several threads and by one whatever the cores of the machine,
+     //  the one thread timed against the reference
+
+     FILE *out[3] = { open_memstream (&txt[0], &len[0]), open_memstream (&txt[1], &len[1]),
+                      open_memstream (&txt[2], &len[2]) } ;
+
+     if (out[0] == NULL || out[1] == NULL || out[2] == NULL)
+     {
+          for (int o = 0 ; o < 3 ; o++)
+               if (out[o] != NULL) fclose (out[o]) ;
+          printf ("%s\t-\tNot checked\n", tag) ;
+          error = 1 ;
+          goto quit ;
+     }
+
+     int saved = save_txt (out[0], &mds, dpm[0], &dsc[0], spk[0], false, NULL, TST_JOB) ;
+     fflush (out[0]) ;
+
+     tick = time_met () ;
+     saved |= save_txt (out[2], &mds, dpm[0], &dsc[0], spk[0], false, NULL, 1) ;
+     fflush (out[2]) ;
+     tim[0][TST_LOG] = time_met () - tick ;
+
+     tick = time_met () ;
+     save_sum (out[1], &mds, dpm[1], &dsc[1], spk[1], false) ;
+     save_sum (out[1], &mds, dpm[1], &dsc[1], spk[1], true) ;
+     ref_log (out[1], &mds, dpm[1], &dsc[1]) ;
+     fflush (out[1]) ;
+     tim[1][TST_LOG] = time_met () - tick ;
+
+     for (int o = 0 ; o < 3 ; o++)
+          fclose (out[o]) ;
+
+     if (saved != 0 || len[0] != len[1] || memcmp (txt[0], txt[1], len[0]))
+          strcat (fail, " log") ;
+     if (len[2] != len[1] || memcmp (txt[2], txt[1], len[2]))
+          strcat (fail, " serial") ;
+
+     show :
+
+     tst->run += 1 ;
+
+     if (fail[0] != 0)
+          { tst->fail += 1 ; error = 2 ; }
+
+     for (int s = 0 ; s < 3 ; s++)
+     {
+          tst->opt[s] += tim[0][s] ;
+          tst->ref[s] += tim[1][s] ;
+     }
+
+     printf ("%s\t%s\t%d\tparse x%.2f\teval x%.2f\tlog x%.2f\t%s\n", tag, fail[0] != 0 ? "DIFF" : "same", mds.smp,
+             rate_tst (tim[1][TST_PARSE], tim[0][TST_PARSE]), rate_tst (tim[1][TST_EVAL], tim[0][TST_EVAL]),
+             rate_tst (tim[1][TST_LOG], tim[0][TST_LOG]), fail[0] != 0 ? fail + 1 : "-") ;
+
+     quit :
+
+     for (int o = 0 ; o < 3 ; o++)
+          free (txt[o]) ;
+
+     free_arn (&arn[0]) ;
+     free_arn (&arn[1]) ;
+
+     return error ;
+}
+
+static int test_gen (TST *tst)
+{
+     // every interval and layer mode, sizes around the block boundaries
+     //  of the kernels, double layer dumps keeping samples on both sides of the break,
+     //  with fixed thresholds, glitches left out or a running median window
+
+     unsigned int itv[4] = {50, 256, 500, 2048} ;
+     unsigned int smp[12] = {1, 2, 3, 7, 8, 9, 64, 1023, 1025, 4097, 8193, 20000} ;
+
+     struct { bool dvd ; unsigned int ptr ; } mode[4] = { {false, 0x10E8}, {true, 0x1000}, {true, 0x10E8}, {true, 0x20EC} } ;
+
+     char *shape[4] = {"reg", "end", "dense", "cut"} ;
+     OPT opt[3] = { {0}, {.glitch = true}, {.win = TST_WIN} } ;
+     char *flag[3] = {"", "+G", "+a"} ;
+     char tag[64] ;
+     int error = 0 ;
+
+     for (int i = 0 ; i < 4 ; i++)
+     for (int m = 0 ; m < 4 ; m++)
+     for (int s = 0 ; s < 12 ; s++)
+     for (int k = 0 ; k < 4 ; k++)
+     for (int o = 0 ; o < 3 ; o++)
+     {
+          GEN gen = {itv[i], mode[m].dvd, mode[m].ptr, s % 2 ? 0x02 : 0x01, smp[s], k} ;
+
+          if (gen.ptr == 0x20EC && gen.smp < 64)
+               continue ;
+
+          size_t len = 0 ;
+
+          unsigned char *buf = make_gen (&gen, &len) ;
+          if (buf == NULL)
+               return 1 ;
+
+          snprintf (tag, sizeof (tag), "gen/%s-%d/%d/%d/%s%s", gen.dvd ? "dvd" : "cd", m == 3 ? 2 : m == 1 ? 0 : 1,
+                    gen.itv, gen.smp, shape[k], flag[o]) ;
+
+          FILE *file = fmemopen (buf, len, "rb") ;
+
+          if (file != NULL)
+               { error |= test_dpm (tag, file, &opt[o], tst) ; fclose (file) ; }
+          else error |= 1 ;
+
+          free (buf) ;
+     }
+
+     return error ;
+}
+
+static int time_gen (GEN *gen, unsigned long *tim)
+{
+     // analysis time of a generated dump, the best of a few runs
+
+     MDS mds = {0} ;
+     OPT opt = {0} ;
+     ARN arn = {0} ;
+     DSC dsc ;
+     SPK *spk = NULL ;
+     size_t len = 0 ;
+
+     unsigned char *buf = make_gen (gen, &len) ;
+     if (buf == NULL)
+          return 1 ;
+
+     FILE *file = fmemopen (buf, len, "rb") ;
+     int error = file == NULL || read_mds (file, &mds) != 0 ;
+
+     *tim = -1 ;
+
+     for (int r = 0 ; r < 3 && error == 0 ; r++)
+     {
+          DPM *dpm = NULL ;
+
+          if (make_arn (&arn, size_arn (&mds, &opt, "time"), false) == 0)
+               dpm = make_dpm (&arn, mds.smp) ;
+
+          if (dpm == NULL)
+               { error = 1 ; break ; }
+
+          read_dpm (file, &mds, dpm) ;
+          memset (&dsc, 0, sizeof (dsc)) ;
+
+          unsigned long tick = time_met () ;
+          eval_dpm (&mds, dpm, &dsc, &spk, &opt, &arn) ;
+          tick = time_met () - tick ;
+
+          if (tick < *tim)
+               *tim = tick ;
+     }
+
+     if (file != NULL)
+          fclose (file) ;
+
+     free_arn (&arn) ;
+     free (buf) ;
+
+     return error ;
+}
+
+static int test_flat (TST *tst)
+{
+     // flat and half truncated curves against a regular one of the same size,
+     //  the segmentation having to stay close to linear on all of them
+
+     GEN reg = {256, false, 0x10E8, 0x01, 65535, GEN_REG} ;
+     GEN flat[2] = { {256, false, 0x10E8, 0x01, 65535, GEN_FLAT}, {256, false, 0x10E8, 0x01, 65535, GEN_CUT} } ;
+     char *shape[2] = {"flat", "cut"} ;
+
+     unsigned long ref = 0 ;
+     int error = 0 ;
+
+     if (time_gen (&reg, &ref) != 0)
+          return 1 ;
+
+     for (int k = 0 ; k < 2 ; k++)
+     {
+          unsigned long tim = 0 ;
+
+          if (time_gen (&flat[k], &tim) != 0)
+               { error |= 1 ; continue ; }
+
+          bool slow = tim > TST_FLAT * ref + 1000000 ;
+
+          tst->run += 1 ;
+          if (slow)
+               { tst->fail += 1 ; error = 2 ; }
+
+          printf ("time/%s/%d\t%s\t%d\teval x%.2f of a regular dump\n", shape[k], flat[k].smp,
+                  slow ? "SLOW" : "same", flat[k].smp, (float) tim / (ref + 1)) ;
+     }
+
+     return error ;
+}
+
+static int same_sto (STO *sto, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk)
+{
+     // every part read back as written, guard samples included,
+     //  the header field by field as its padding is not copied
+
+     MDS *got = sto->mds ;
+     unsigned int spk_cnt = spk != NULL && dsc->dpm_cat == 0 ? dsc->dec_cnt / dsc->stp_cnt : 0 ;
+
+     if (got->cd != mds->cd || got->dvd != mds->dvd || got->ptr != mds->ptr || got->lay != mds->lay
+         || memcmp (got->mod, mds->mod, sizeof (mds->mod)) != 0 || got->loc != mds->loc
+         || got->itv != mds->itv || got->smp != mds->smp || got->sct != mds->sct)
+          return 1 ;
+
+     if (memcmp (sto->dpm - DPM_PAD, dpm - DPM_PAD, (size_t) (mds->smp + 2 * DPM_PAD) * sizeof (DPM)) != 0)
+          return 2 ;
+     if (memcmp (sto->dsc, dsc, sizeof (DSC)) != 0)
+          return 3 ;
+
+     if (spk_cnt == 0 ? sto->spk != NULL : sto->spk == NULL || memcmp (sto->spk, spk, spk_cnt * sizeof (SPK)) != 0)
+          return 4 ;
+
+     return 0 ;
+}
+
+static int test_sto (TST *tst)
+{
+     // analyzed dumps sealed in a store, read back once passed over a socket
+     //  and once opened by its path under /proc
+
+     GEN gen[2] = { {256, false, 0x10E8, 0x01, 20000, GEN_REG}, {500, true, 0x20EC, 0x02, 20000, GEN_REG} } ;
+     char *way[2] = {"passed", "path"} ;
+
+     int error = 0 ;
+
+     for (int g = 0 ; g < 2 ; g++)
+     {
+          MDS mds = {0} ;
+          OPT opt = {0} ;
+          ARN arn = {0} ;
+          DSC dsc = {0} ;
+          STO sto = {0} ;
+          SPK *spk = NULL ;
+          DPM *dpm = NULL ;
+          size_t len = 0 ;
+
+          unsigned char *buf = make_gen (&gen[g], &len) ;
+          if (buf == NULL)
+               return 1 ;
+
+          FILE *file = fmemopen (buf, len, "rb") ;
+
+          if (file != NULL && read_mds (file, &mds) == 0 && make_arn (&arn, size_arn (&mds, &opt, "store"), false) == 0)
+               dpm = make_dpm (&arn, mds.smp) ;
+
+          if (dpm != NULL)
+               read_dpm (file, &mds, dpm) ;
+
+          if (dpm == NULL || eval_dpm (&mds, dpm, &dsc, &spk, &opt, &arn) == 2 || make_sto (&sto, &mds, dpm, &dsc, spk, "store") != 0)
+               error |= 1 ;
+
+          for (int w = 0 ; w < 2 && sto.base != NULL ; w++)
+          {
+               STO got = {0} ;
+               char head[16] ;
+               char path[64] ;
+               int pair[2] = {-1, -1} ;
+               int state = 1 ;
+
+               if (w == 0 && socketpair (AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, pair) == 0)
+               {
+                    if (pass_sto (pair[0], sto.fd, "STO\n") == 0)
+                         state = take_sto (&got, pair[1], 0, head, sizeof (head)) ;
+
+                    close (pair[0]) ;
+                    close (pair[1]) ;
+               }
+
+               if (w == 1)
+               {
+                    snprintf (path, sizeof (path), "/proc/self/fd/%d", sto.fd) ;
+                    state = find_sto (&got, path) ;
+               }
+
+               if (state == 0)
+                    state = same_sto (&got, &mds, dpm, &dsc, spk) ;
+
+               tst->run += 1 ;
+               if (state != 0)
+                    { tst->fail += 1 ; error = 2 ; }
+
+               printf ("store/%s/%d/%s\t%s\t%d\t%zu bytes\n", mds.dvd ? "dvd" : "cd", mds.itv, way[w],
+                       state != 0 ? "DIFF" : "same", mds.smp, sto.size) ;
+
+               shut_sto (&got) ;
+          }
+
+          shut_sto (&sto) ;
+
+          if (file != NULL)
+               fclose (file) ;
+
+          free_arn (&arn) ;
+          free (buf) ;
+     }
+
+     return error ;
+}
+
+int verify (char **path, int count)
+{
+     TST tst = {0} ;
+     OPT opt = {0} ;
+
+     int error = test_gen (&tst) ;
+
+     error |= test_flat (&tst) ;
+     error |= test_sto (&tst) ;
+
+     for (int i = 0 ; i < count ; i++)
+     {
+          FILE *file = fopen (path[i], "rb") ;
+
+          if (file == NULL)
+               { printf ("%s\t-\tNo file\n", path[i]) ; error |= 1 ; continue ; }
+
+          error |= test_dpm (path[i], file, &opt, &tst) ;
+
+          fclose (file) ;
+     }
+
+     printf ("\nChecked    \t %d dumps, %d differ\n", tst.run, tst.fail) ;
+     printf ("Speedup    \t parse x%.2f \t eval x%.2f \t log x%.2f\n",
+             rate_tst (tst.ref[TST_PARSE], tst.opt[TST_PARSE]), rate_tst (tst.ref[TST_EVAL], tst.opt[TST_EVAL]),
+             rate_tst (tst.ref[TST_LOG], tst.opt[TST_LOG])) ;
+
+     // an optimized stage slower than its reference over all dumps fails
+
+     char *stage[3] = {"parse", "eval", "log"} ;
+     bool slow = false ;
+
+     for (int s = 0 ; s < 3 ; s++)
+     {
+          if (tst.opt[s] > tst.ref[s])
+          {
+               printf ("%s%s", slow ? ", " : "Slower     \t ", stage[s]) ;
+               slow = true ;
+          }
+     }
+
+     if (slow)
+          printf (" than the reference\n") ;
+
+     return tst.fail != 0 || slow ? 2 : error ;
+}
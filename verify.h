@@ -0,0 +1,114 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef VERIFY_H
+# define VERIFY_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <math.h>
+
+# include "type.h"
+# include "arena.h"
+# include "parse.h"
+# include "scan.h"
+# include "log.h"
+# include "metric.h"
+# include "store.h"
+
+// shapes of the generated dumps
+
+# define GEN_REG 0
+# define GEN_END 1
+# define GEN_DENSE 2
+# define GEN_CUT 3
+# define GEN_FLAT 4
+
+typedef struct gen
+{
+     unsigned int itv ;
+     bool dvd ;
+     unsigned int ptr ;
+     unsigned char loc ;
+     unsigned int smp ;
+     unsigned char shape ;
+}
+GEN ;
+
+// time spent per stage by the optimized paths and by the reference
+
+# define TST_PARSE 0
+# define TST_EVAL 1
+# define TST_LOG 2
+
+// threads forced on the parallel sample lines, window of the median detector
+
+# define TST_JOB 4
+# define TST_WIN 64
+
+// most a flat or truncated dump may take to analyze, in regular dumps
+
+# define TST_FLAT 4
+
+// longest layer searched exhaustively by the reference segmentation
+
+# define TST_OPT 5000
+
+typedef struct tst
+{
+     unsigned long opt[3] ;
+     unsigned long ref[3] ;
+     unsigned int run ;
+     unsigned int fail ;
+}
+TST ;
+
+static int ref_dpm (FILE *file, MDS *mds, DPM *dpm) ;
+static int ref_brk (MDS *mds, DPM *dpm, DSC *dsc) ;
+static int ref_int (const void *a, const void *b) ;
+static int ref_spk_ada (MDS *mds, DPM *dpm, DSC *dsc, int smp_stt, int smp_stp,
+                        signed int *srt, signed int *dst, unsigned int win) ;
+static int ref_spk (MDS *mds, DPM *dpm, DSC *dsc, int layer, signed int *srt, signed int *dst, unsigned int win) ;
+static int ref_spk_50 (MDS *mds, DPM *dpm, DSC *dsc) ;
+static unsigned int ref_glt (MDS *mds, DPM *dpm, int mode) ;
+static int ref_dis (DPM *dpm, int smp_stt, int smp_stp, DIS *dis, unsigned int *cnt) ;
+static int ref_dist (MDS *mds, DPM *dpm, DSC *dsc, ARN *arn) ;
+static int ref_amp (MDS *mds, DPM *dpm, DSC *dsc) ;
+static int ref_reg (MDS *mds, DSC *dsc) ;
+static unsigned int ref_part (SPL *spl, DPM *dpm, int smp_stt, int smp_stp, double pen) ;
+static int ref_seg (MDS *mds, DSC *dsc, SPL *spl, int smp_stt, unsigned int cnt, unsigned int itv) ;
+static int ref_split (MDS *mds, DPM *dpm, DSC *dsc, unsigned int itv, ARN *arn) ;
+static int ref_cat (DSC *dsc) ;
+static int ref_len (DSC *dsc, SPK *spk) ;
+static int ref_eval (MDS *mds, DPM *dpm, DSC *dsc, SPK **spk, OPT *opt, ARN *arn) ;
+static int ref_log (FILE *file, MDS *mds, DPM *dpm, DSC *dsc) ;
+static unsigned int next_gen (unsigned int *seed) ;
+static unsigned char *make_gen (GEN *gen, size_t *len) ;
+static float rate_tst (unsigned long ref, unsigned long opt) ;
+static int test_dpm (char *tag, FILE *file, OPT *opt, TST *tst) ;
+static int test_gen (TST *tst) ;
+static int time_gen (GEN *gen, unsigned long *tim) ;
+static int test_flat (TST *tst) ;
+static int same_sto (STO *sto, MDS *mds, DPM *dpm, DSC *dsc, SPK *spk) ;
+static int test_sto (TST *tst) ;
+
+int verify (char **path, int count) ;
+
+# endif
@@ -0,0 +1,393 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# include "watch.h"
+
+static volatile sig_atomic_t halt = 0 ;
+
+static void stop_que (int signal)
+{
+     halt = 1 ;
+}
+
+static int push_que (QUE *que, char *path)
+{
+     pthread_mutex_lock (&que->lock) ;
+
+     // a waiting file is analyzed once with its latest content
+
+     for (int i = 0 ; i < que->cnt ; i++)
+     {
+          if (strcmp (que->path[(que->head + i) % QUE_LEN], path) == 0)
+          {
+               pthread_mutex_unlock (&que->lock) ;
+               return 1 ;
+          }
+     }
+
+     // a file rewritten during its analysis is analyzed again afterwards
+
+     for (int i = 0 ; i < que->jobs ; i++)
+     {
+          if (strcmp (que->busy[i], path) == 0)
+          {
+               que->redo[i] = true ;
+               pthread_mutex_unlock (&que->lock) ;
+               return 1 ;
+          }
+     }
+
+     // back-pressure, stop reading events while the queue is full
+
+     while (que->cnt == QUE_LEN && ! halt)
+     {
+          struct timespec time = {0} ;
+
+          clock_gettime (CLOCK_REALTIME, &time) ;
+          time.tv_sec += 1 ;
+
+          pthread_cond_timedwait (&que->room, &que->lock, &time) ;
+     }
+
+     if (que->cnt == QUE_LEN)
+     {
+          pthread_mutex_unlock (&que->lock) ;
+          return 2 ;
+     }
+
+     strcpy (que->path[(que->head + que->cnt) % QUE_LEN], path) ;
+     que->cnt += 1 ;
+
+     pthread_cond_signal (&que->fill) ;
+     pthread_mutex_unlock (&que->lock) ;
+
+     return 0 ;
+}
+
+static int pull_que (QUE *que, unsigned int num, char *path)
+{
+     pthread_mutex_lock (&que->lock) ;
+
+     while (que->cnt == 0 && ! que->stop)
+          pthread_cond_wait (&que->fill, &que->lock) ;
+
+     if (que->cnt == 0)
+     {
+          pthread_mutex_unlock (&que->lock) ;
+          return 1 ;
+     }
+
+     strcpy (path, que->path[que->head]) ;
+     strcpy (que->busy[num], path) ;
+     que->redo[num] = false ;
+
+     que->head = (que->head + 1) % QUE_LEN ;
+     que->cnt -= 1 ;
+
+     pthread_cond_signal (&que->room) ;
+     pthread_mutex_unlock (&que->lock) ;
+
+     return 0 ;
+}
+
+static bool done_que (QUE *que, unsigned int num)
+{
+     bool again = false ;
+
+     pthread_mutex_lock (&que->lock) ;
+
+     if (que->redo[num])
+     {
+          que->redo[num] = false ;
+          again = true ;
+     }
+     else que->busy[num][0] = '\0' ;
+
+     pthread_mutex_unlock (&que->lock) ;
+
+     return again ;
+}
+
+static int scan_dir (QUE *que, char *dir)
+{
+     DIR *list = opendir (dir) ;
+     if (list == NULL)
+          return 1 ;
+
+     struct dirent *entry = NULL ;
+     char path[PATH_MAX] ;
+
+     while ((entry = readdir (list)) != NULL && ! halt)
+     {
+          unsigned int len = strlen (entry->d_name) ;
+
+          if (len < 5 || strcmp (entry->d_name + len - 4, ".mds") != 0)
+               continue ;
+
+          snprintf (path, PATH_MAX, "%s/%s", dir, entry->d_name) ;
+          push_que (que, path) ;
+     }
+
+     closedir (list) ;
+
+     return 0 ;
+}
+
+static int work_mds (WORK *work, char *path)
+{
+     FILE *file = NULL ;
+     MDS mds = {0} ;
+     char *name = NULL ;
+     DPM *dpm = NULL ;
+     SPK *spk = NULL ;
+
+     int error = 0 ;
+     int cat = -1 ;
+
+     unsigned long tick = time_met () ;
+
+     file = fopen (path, "rb") ;
+     if (file == NULL)
+          { error = 3 ; goto quit ; }
+
+     if (read_mds (file, &mds) != 0)
+          { error = 7 ; goto quit ; }
+
+     // the arena is kept from one file to the next and only grows
+
+     if (make_arn (&work->arn, size_arn (&mds, work->opt, path), work->opt->huge) != 0)
+          { error = 4 ; goto quit ; }
+
+     if (get_name (path, &name, &work->arn) != 0)
+          { error = 2 ; goto quit ; }
+
+     dpm = make_dpm (&work->arn, mds.smp) ;
+     if (dpm == NULL)
+          { error = 4 ; goto quit ; }
+
+     read_dpm (file, &mds, dpm) ;
+
+     fclose (file) ;
+     file = NULL ;
+
+     span_met (MET_PARSE, tick) ;
+     byte_met (MET_IN, base_dpm (&mds) + mds.smp * sizeof (unsigned int)) ;
+
+     DSC dsc = {0} ;
+
+     tick = time_met () ;
+
+     int state = eval_dpm (&mds, dpm, &dsc, &spk, work->opt, &work->arn) ;
+
+     span_met (MET_EVAL, tick) ;
+
+     if (state == 2)
+          { error = 5 ; goto quit ; }
+     if (state == 3)
+          { error = 10 ; goto quit ; }
+
+     cat = dsc.dpm_cat ;
+     tick = time_met () ;
+
+     if (save_log (&mds, dpm, &dsc, spk, name, work->opt, &work->arn) != 0)
+          { error = 6 ; goto quit ; }
+
+     span_met (MET_SAVE, tick) ;
+
+     pthread_mutex_lock (&work->que->draw) ;
+     bool fail = save_bmp (&mds, dpm, name, &work->arn) ;
+     pthread_mutex_unlock (&work->que->draw) ;
+
+     if (fail)
+          { error = 11 ; goto quit ; }
+
+     quit :
+
+     file_met (error, cat, mds.smp) ;
+
+     if (file != NULL)
+          fclose (file) ;
+
+     return error ;
+}
+
+static void *work_que (void *arg)
+{
+     WORK *work = arg ;
+     char path[PATH_MAX] ;
+
+     while (pull_que (work->que, work->num, path) == 0)
+     {
+          do
+          {
+               int error = work_mds (work, path) ;
+
+               if (error != 0)
+                    fprintf (stderr, "%s \e[1;31mError # %d\e[0m\n", path, error) ;
+               else fprintf (stdout, "%s\n", path) ;
+
+               fflush (stdout) ;
+          }
+          while (done_que (work->que, work->num)) ;
+     }
+
+     return NULL ;
+}
+
+int watch (char *dir, OPT *opt)
+{
+     QUE *que = NULL ;
+     WORK *work = NULL ;
+     pthread_t *thread = NULL ;
+     unsigned int started = 0 ;
+
+     unsigned int jobs = opt->job ;
+     int fd = -1 ;
+     int error = 0 ;
+
+     if (jobs == 0)
+          jobs = sysconf (_SC_NPROCESSORS_ONLN) ;
+
+     que = calloc (1, sizeof (QUE)) ;
+     if (que == NULL)
+          { error = 1 ; goto quit ; }
+
+     que->jobs = jobs ;
+     que->busy = calloc (jobs, PATH_MAX) ;
+     que->redo = calloc (jobs, sizeof (bool)) ;
+     work = calloc (jobs, sizeof (WORK)) ;
+     thread = calloc (jobs, sizeof (pthread_t)) ;
+
+     if (que->busy == NULL || que->redo == NULL || work == NULL || thread == NULL)
+          { error = 1 ; goto quit ; }
+
+     fd = inotify_init1 (IN_CLOEXEC) ;
+     if (fd < 0)
+          { error = 2 ; goto quit ; }
+
+     // renamed files are complete as well, stations may write then move
+
+     if (inotify_add_watch (fd, dir, IN_CLOSE_WRITE | IN_MOVED_TO) < 0)
+          { error = 3 ; goto quit ; }
+
+     pthread_mutex_init (&que->lock, NULL) ;
+     pthread_mutex_init (&que->draw, NULL) ;
+     pthread_cond_init (&que->fill, NULL) ;
+     pthread_cond_init (&que->room, NULL) ;
+
+     // workers leave the stop signals to the event loop
+
+     sigset_t mask = {0} ;
+     sigset_t prev = {0} ;
+
+     sigemptyset (&mask) ;
+     sigaddset (&mask, SIGINT) ;
+     sigaddset (&mask, SIGTERM) ;
+     pthread_sigmask (SIG_BLOCK, &mask, &prev) ;
+
+     for (int i = 0 ; i < jobs ; i++)
+     {
+          work[i].que = que ;
+          work[i].opt = opt ;
+          work[i].num = i ;
+
+          if (pthread_create (&thread[started], NULL, work_que, &work[i]) != 0)
+               break ;
+          started += 1 ;
+     }
+
+     pthread_sigmask (SIG_SETMASK, &prev, NULL) ;
+
+     struct sigaction action = {0} ;
+
+     action.sa_handler = stop_que ;
+     sigaction (SIGINT, &action, NULL) ;
+     sigaction (SIGTERM, &action, NULL) ;
+
+     char buf[4096] __attribute__ ((aligned (__alignof__ (struct inotify_event)))) ;
+     char path[PATH_MAX] ;
+
+     while (! halt && started > 0)
+     {
+          ssize_t len = read (fd, buf, sizeof (buf)) ;
+
+          if (len < 0 && errno == EINTR)
+               continue ;
+          if (len <= 0)
+               break ;
+
+          for (char *ptr = buf ; ptr < buf + len ; )
+          {
+               struct inotify_event *event = (struct inotify_event *) ptr ;
+               ptr += sizeof (struct inotify_event) + event->len ;
+
+               // events were dropped by the kernel, look for files again
+
+               if (event->mask & IN_Q_OVERFLOW)
+               {
+                    scan_dir (que, dir) ;
+                    continue ;
+               }
+
+               unsigned int size = event->len ? strlen (event->name) : 0 ;
+
+               if (size < 5 || strcmp (event->name + size - 4, ".mds") != 0)
+                    continue ;
+
+               snprintf (path, PATH_MAX, "%s/%s", dir, event->name) ;
+               push_que (que, path) ;
+          }
+     }
+
+     // finish the queued files before leaving
+
+     pthread_mutex_lock (&que->lock) ;
+     que->stop = true ;
+     pthread_cond_broadcast (&que->fill) ;
+     pthread_mutex_unlock (&que->lock) ;
+
+     for (int i = 0 ; i < started ; i++)
+          pthread_join (thread[i], NULL) ;
+
+     pthread_cond_destroy (&que->room) ;
+     pthread_cond_destroy (&que->fill) ;
+     pthread_mutex_destroy (&que->draw) ;
+     pthread_mutex_destroy (&que->lock) ;
+
+     quit :
+
+     if (fd >= 0)
+          close (fd) ;
+
+     for (int i = 0 ; work != NULL && i < jobs ; i++)
+          free_arn (&work[i].arn) ;
+
+     if (thread != NULL)
+          free (thread) ;
+     if (work != NULL)
+          free (work) ;
+     if (que != NULL && que->redo != NULL)
+          free (que->redo) ;
+     if (que != NULL && que->busy != NULL)
+          free (que->busy) ;
+     if (que != NULL)
+          free (que) ;
+
+     return error ;
+}
@@ -0,0 +1,82 @@
+// DPM SCN
+// Disc image utility that displays and analyzes DPM timings from MDS files
+// Copyright (c) 2025 Jon Blau
+
+// SPDX-License-Identifier: GPL-3.0-or-later
+
+// This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+
+// This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+//  GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License
+//  along with this program. If not, see <https://www.gnu.org/licenses/>.
+
+# ifndef WATCH_H
+# define WATCH_H
+
+# include <stdio.h>
+# include <stdlib.h>
+# include <string.h>
+# include <stdbool.h>
+# include <errno.h>
+# include <limits.h>
+# include <signal.h>
+# include <dirent.h>
+# include <unistd.h>
+# include <pthread.h>
+# include <sys/inotify.h>
+
+# include "type.h"
+# include "arena.h"
+# include "parse.h"
+# include "draw.h"
+# include "scan.h"
+# include "log.h"
+# include "metric.h"
+
+// pending files, further events wait for a free slot
+
+# define QUE_LEN 64
+
+typedef struct que
+{
+     char path[QUE_LEN][PATH_MAX] ;
+     unsigned int head ;
+     unsigned int cnt ;
+     char (*busy)[PATH_MAX] ;
+     bool *redo ;
+     unsigned int jobs ;
+     bool stop ;
+     pthread_mutex_t lock ;
+     pthread_mutex_t draw ;
+     pthread_cond_t fill ;
+     pthread_cond_t room ;
+}
+QUE ;
+
+typedef struct work
+{
+     QUE *que ;
+     OPT *opt ;
+     unsigned int num ;
+     ARN arn ;
+}
+WORK ;
+
+static void stop_que (int signal) ;
+static int push_que (QUE *que, char *path) ;
+static int pull_que (QUE *que, unsigned int num, char *path) ;
+static bool done_que (QUE *que, unsigned int num) ;
+static int scan_dir (QUE *que, char *dir) ;
+static int work_mds (WORK *work, char *path) ;
+static void *work_que (void *arg) ;
+
+int watch (char *dir, OPT *opt) ;
+
+# endif